@@ -65,6 +65,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #  endif//!defined(NDEBUG)
 #endif/*defined(USCHEME_DEBUG)*/
 
+#if !defined(USCHEME_HUGE_PAGES)
+#  define USCHEME_HUGE_PAGES 0
+#endif/*!defined(USCHEME_HUGE_PAGES)*/
+
 namespace uscheme {
 
     USCHEME_API
@@ -56,6 +56,24 @@ namespace uscheme {
                 return "String literal not followed by delimiter.";
             case ERR_TERM_EMPTY:
                 return "Empty list not terminated with ')', or no whitespace after.";
+            case ERR_INV_SYM:
+                return "Invalid character in symbol.";
+            case ERR_TERM_LIST:
+                return "List not terminated with ')', or no delimiter after.";
+            case ERR_TERM_VEC:
+                return "Vector not terminated with ')', or no delimiter after.";
+            case ERR_NOT_VEC:
+                return "Expected a vector.";
+            case ERR_VEC_RANGE:
+                return "Vector index out of range.";
+            case ERR_NOT_INT:
+                return "Expected an integer.";
+            case ERR_FILE_OPEN:
+                return "Could not open file.";
+            case ERR_FASL_HDR:
+                return "Not a fasl stream, or from another version.";
+            case ERR_FASL_DATA:
+                return "Malformed or truncated fasl record.";
             default:
                 return "Unknown error.";
         }
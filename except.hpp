@@ -50,7 +50,16 @@ namespace uscheme {
         ERR_CHAR_TB,
         ERR_STR_ABR,
         ERR_TERM_STR,
-        ERR_TERM_EMPTY
+        ERR_TERM_EMPTY,
+        ERR_INV_SYM,
+        ERR_TERM_LIST,
+        ERR_TERM_VEC,
+        ERR_NOT_VEC,
+        ERR_VEC_RANGE,
+        ERR_NOT_INT,
+        ERR_FILE_OPEN,
+        ERR_FASL_HDR,
+        ERR_FASL_DATA
     };
 
     USCHEME_API
@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
 #include <uscheme/exec/exec.hpp>
+#include <uscheme/gc/heap.hpp>
+#include <uscheme/stream/file.hpp>
 
 namespace uscheme {
 
@@ -37,4 +39,17 @@ namespace uscheme {
         return p;
     }
 
+    object_ptr load_file(const char* path)
+    {
+        object_ptr forms = read_file(path, 0);
+        gc_root forms_root(forms);
+        object_ptr result = empty_list_value();
+        gc_root result_root(result);
+
+        for (; forms.is_pair(); forms = forms->cdr()) {
+            result = eval_object(forms->car());
+        }
+        return result;
+    }
+
 }//namespace uscheme
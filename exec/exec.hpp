@@ -40,6 +40,13 @@ namespace uscheme {
     USCHEME_API
     object_ptr eval_object(const object_ptr& p);
 
+    USCHEME_API
+    /**
+     * Read the file at path, in parallel, and evaluate its objects in order.
+     * Returns the value of the last one, or the empty list for an empty file.
+     */
+    object_ptr load_file(const char* path);
+
 }//namespace uscheme
 
 #endif//USCHEME_EXEC_EXEC_HPP
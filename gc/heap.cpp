@@ -0,0 +1,480 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file heap.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// PKG includes
+#include <uscheme/gc/heap.hpp>
+#include <uscheme/gc/slab.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    gc_nursery GC_NURSERY = { nullptr, nullptr, nullptr, nullptr };
+
+    /* the arena allocations on this thread are taken from, if any */
+    static thread_local gc_arena* ARENA = nullptr;
+
+    /**
+     * The managed object heap. Cells are born in a bump allocated nursery
+     * and copied Cheney style into the old generation when they survive a
+     * minor collection. The old generation is a precise, non-moving
+     * mark-and-sweep heap of slab allocated cells. Old cells that reference
+     * young ones are kept in a remembered set, filled by the write barrier,
+     * and act as extra roots for minor collections.
+     */
+    class heap
+    {
+      public:
+        heap()
+          : nursery_(nullptr)
+          , nursery_full_(false)
+          , objects_()
+          , stack_()
+          , remembered_()
+          , fresh_()
+          , roots_(nullptr)
+          , allocated_since_gc_(0)
+          , threshold_(MIN_THRESHOLD)
+          , stats_()
+        { }
+
+        ~heap()
+        {
+            if (nursery_) {
+                each_young(GC_NURSERY.top, [this](object* o) { o->destroy(); });
+                free(nursery_);
+                GC_NURSERY = gc_nursery();
+            }
+            for (size_t i = 0; i != objects_.size(); ++i) {
+                release(objects_[i]);
+            }
+        }
+
+        void* allocate(size_t size)
+        {
+            if (!nursery_) {
+                nursery_ = static_cast<char*>(malloc(NURSERY_SIZE));
+                if (nursery_) {
+                    GC_NURSERY.base = GC_NURSERY.top = nursery_;
+                    GC_NURSERY.end = GC_NURSERY.limit = nursery_ + NURSERY_SIZE;
+                    if (size <= LARGE_OBJECT_SIZE) {
+                        return gc_allocate(size);
+                    }
+                }
+            }
+            /* too large for the nursery, or it is full until the next safepoint */
+            if (size <= LARGE_OBJECT_SIZE) {
+                nursery_full_ = true;
+            }
+            object* p = static_cast<object*>(slab_allocate(size));
+            objects_.push_back(p);
+            allocated_since_gc_ += size;
+            stats_.bytes_allocated += size;
+            /* its fields are written without a barrier while it is built;
+               the constructor has not run yet, so it cannot be flagged and
+               is scanned from its own list instead */
+            fresh_.push_back(p);
+            return p;
+        }
+
+        void adopt(gc_arena& a)
+        {
+            /* arena cells only reference each other, never young cells */
+            objects_.insert(objects_.end(), a.cells_.begin(), a.cells_.end());
+            allocated_since_gc_ += a.bytes_;
+            stats_.bytes_allocated += a.bytes_;
+            a.cells_.clear();
+            a.bytes_ = 0;
+        }
+
+        void add_root(gc_root* r)
+        {
+            r->prev_ = nullptr;
+            r->next_ = roots_;
+            if (roots_) {
+                roots_->prev_ = r;
+            }
+            roots_ = r;
+        }
+
+        void remove_root(gc_root* r)
+        {
+            if (r->prev_) {
+                r->prev_->next_ = r->next_;
+            } else {
+                roots_ = r->next_;
+            }
+            if (r->next_) {
+                r->next_->prev_ = r->prev_;
+            }
+        }
+
+        void remember(object* o)
+        {
+            if (!(o->flags_ & REMEMBERED)) {
+                o->flags_ |= REMEMBERED;
+                remembered_.push_back(o);
+            }
+        }
+
+        void collect_young()
+        {
+            if (!nursery_) {
+                fresh_.clear();
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+
+            /* survivors are appended to objects_, which doubles as the
+               Cheney scan queue */
+            size_t scan = objects_.size();
+            for (gc_root* r = roots_; r; r = r->next_) {
+                evacuate(*r->slot_);
+            }
+            for (size_t i = 0; i != remembered_.size(); ++i) {
+                object* o = remembered_[i];
+                o->flags_ &= ~REMEMBERED;
+                each_ref(o, [this](object_ptr& p) { evacuate(p); });
+            }
+            remembered_.clear();
+            for (size_t i = 0; i != fresh_.size(); ++i) {
+                each_ref(fresh_[i], [this](object_ptr& p) { evacuate(p); });
+            }
+            fresh_.clear();
+            while (scan != objects_.size()) {
+                each_ref(objects_[scan++], [this](object_ptr& p) { evacuate(p); });
+            }
+
+            char* const top = GC_NURSERY.top;
+            each_young(top, [this](object* o) {
+                o->destroy();
+                ++stats_.objects_freed;
+            });
+            stats_.bytes_allocated += top - nursery_;
+            GC_NURSERY.top = nursery_;
+            nursery_full_ = false;
+
+            const size_t ns = elapsed_ns(start);
+            stats_.minor_pause_ns += ns;
+            if (ns > stats_.minor_pause_max_ns) {
+                stats_.minor_pause_max_ns = ns;
+            }
+            ++stats_.minor_collections;
+        }
+
+        void collect()
+        {
+            collect_young();
+            const auto start = std::chrono::steady_clock::now();
+            for (gc_root* r = roots_; r; r = r->next_) {
+                mark(*r->slot_);
+            }
+            drain();
+            sweep();
+            allocated_since_gc_ = 0;
+            threshold_ = stats_.bytes_live * 2;
+            if (threshold_ < MIN_THRESHOLD) {
+                threshold_ = MIN_THRESHOLD;
+            }
+            stats_.major_pause_ns += elapsed_ns(start);
+            ++stats_.collections;
+        }
+
+        void safepoint()
+        {
+            if (nursery_full_ ||
+                static_cast<size_t>(GC_NURSERY.top - nursery_) >= NURSERY_TRIGGER) {
+                collect_young();
+            }
+            if (allocated_since_gc_ >= threshold_) {
+                collect();
+            }
+        }
+
+        gc_stats stats() const
+        {
+            gc_stats s = stats_;
+            s.objects_live = objects_.size();
+            if (nursery_) {
+                each_young(GC_NURSERY.top, [&s](object*) { ++s.objects_live; });
+                s.bytes_allocated += GC_NURSERY.top - nursery_;
+            }
+            return s;
+        }
+
+      private:
+        friend class gc_arena;
+
+        static const size_t MIN_THRESHOLD = 1 << 20;
+        static const size_t NURSERY_SIZE = 1 << 18;
+        static const size_t NURSERY_TRIGGER = NURSERY_SIZE / 2;
+        static const size_t LARGE_OBJECT_SIZE = NURSERY_SIZE / 16;
+
+        /* object::flags_ bits */
+        static const uint8_t FORWARDED = 0x01;
+        static const uint8_t REMEMBERED = 0x02;
+
+        static size_t elapsed_ns(std::chrono::steady_clock::time_point start)
+        {
+            return static_cast<size_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+        }
+
+        static size_t cell_size(const object* o)
+        {
+            return (o->size() + GC_ALIGN - 1) & ~(GC_ALIGN - 1);
+        }
+
+        /* call f on every reference field of o */
+        template <typename F>
+        static void each_ref(object* o, F f)
+        {
+            switch (o->type()) {
+                case PAIR: {
+                    f(o->data_.pair.car);
+                    f(o->data_.pair.cdr);
+                    break;
+                }
+                case VECTOR: {
+                    object_ptr* e = o->data_.vector.elements;
+                    for (size_t i = 0; i != o->data_.vector.length; ++i) {
+                        f(e[i]);
+                    }
+                    break;
+                }
+                case STRING:
+                default: {
+                    /* no heap references */
+                    (void)f;
+                    break;
+                }
+            }
+        }
+
+        /* call f on every young cell below top that was not copied out */
+        template <typename F>
+        void each_young(char* top, F f) const
+        {
+            char* c = nursery_;
+            while (c != top) {
+                object* o = reinterpret_cast<object*>(c);
+                if (o->flags_ & FORWARDED) {
+                    c += cell_size(o->data_.forward);
+                } else {
+                    c += cell_size(o);
+                    f(o);
+                }
+            }
+        }
+
+        void evacuate(object_ptr& p)
+        {
+            if (!p.is_heap() || !gc_is_young(p.get())) {
+                return;
+            }
+            object* o = p.get();
+            if (!(o->flags_ & FORWARDED)) {
+                const size_t size = cell_size(o);
+                object* copy = static_cast<object*>(slab_allocate(size));
+                memcpy(copy, o, size);
+                copy->flags_ = 0;
+                objects_.push_back(copy);
+                o->flags_ = FORWARDED;
+                o->data_.forward = copy;
+                allocated_since_gc_ += size;
+                stats_.bytes_promoted += size;
+            }
+            p = object_ptr::from_object(o->data_.forward);
+        }
+
+        void mark(object_ptr& p)
+        {
+            if (!p.is_heap()) {
+                return;
+            }
+            object* o = p.get();
+            if (!o->mark_) {
+                o->mark_ = 1;
+                stack_.push_back(o);
+            }
+        }
+
+        void drain()
+        {
+            while (!stack_.empty()) {
+                object* o = stack_.back();
+                stack_.pop_back();
+                each_ref(o, [this](object_ptr& p) { mark(p); });
+            }
+        }
+
+        void sweep()
+        {
+            size_t live = 0;
+            size_t bytes = 0;
+            for (size_t i = 0; i != objects_.size(); ++i) {
+                object* o = objects_[i];
+                if (o->mark_) {
+                    o->mark_ = 0;
+                    objects_[live++] = o;
+                    bytes += cell_size(o);
+                } else {
+                    release(o);
+                    ++stats_.objects_freed;
+                }
+            }
+            objects_.resize(live);
+            stats_.bytes_live = bytes;
+        }
+
+        void release(object* o)
+        {
+            o->destroy();
+            slab_free(o, cell_size(o));
+        }
+
+        char*                nursery_;
+        bool                 nursery_full_;
+        std::vector<object*> objects_;
+        std::vector<object*> stack_;
+        std::vector<object*> remembered_;
+        std::vector<object*> fresh_;
+        gc_root*             roots_;
+        size_t               allocated_since_gc_;
+        size_t               threshold_;
+        gc_stats             stats_;
+    };
+
+    static heap& the_heap()
+    {
+        static heap HEAP;
+        return HEAP;
+    }
+
+    gc_root::gc_root(object_ptr& slot)
+      : slot_(&slot)
+      , prev_(nullptr)
+      , next_(nullptr)
+    {
+        the_heap().add_root(this);
+    }
+
+    gc_root::~gc_root()
+    {
+        the_heap().remove_root(this);
+    }
+
+    gc_arena::gc_arena()
+      : cells_()
+      , bytes_(0)
+    { }
+
+    gc_arena::~gc_arena()
+    {
+        for (size_t i = 0; i != cells_.size(); ++i) {
+            the_heap().release(cells_[i]);
+        }
+    }
+
+    void* gc_arena::allocate(size_t size)
+    {
+        object* p = static_cast<object*>(slab_allocate(size));
+        cells_.push_back(p);
+        bytes_ += size;
+        return p;
+    }
+
+    gc_arena_scope::gc_arena_scope(gc_arena& arena)
+      : prev_(ARENA)
+    {
+        ARENA = &arena;
+    }
+
+    gc_arena_scope::~gc_arena_scope()
+    {
+        ARENA = prev_;
+    }
+
+    gc_parallel_scope::gc_parallel_scope()
+    {
+        GC_NURSERY.limit = GC_NURSERY.top;
+    }
+
+    gc_parallel_scope::~gc_parallel_scope()
+    {
+        GC_NURSERY.limit = GC_NURSERY.end;
+    }
+
+    void gc_adopt(gc_arena& arena)
+    {
+        the_heap().adopt(arena);
+    }
+
+    void* gc_allocate_slow(size_t size)
+    {
+        if (gc_arena* a = ARENA) {
+            return a->allocate(size);
+        }
+        return the_heap().allocate(size);
+    }
+
+    void gc_remember(object* owner)
+    {
+        the_heap().remember(owner);
+    }
+
+    void collect_garbage(void)
+    {
+        the_heap().collect();
+    }
+
+    void collect_young_garbage(void)
+    {
+        the_heap().collect_young();
+    }
+
+    void gc_safepoint(void)
+    {
+        the_heap().safepoint();
+    }
+
+    gc_stats gc_statistics(void)
+    {
+        return the_heap().stats();
+    }
+
+}//namespace uscheme
@@ -0,0 +1,249 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file heap.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_GC_HEAP_HPP
+#define USCHEME_GC_HEAP_HPP
+
+// LANG includes
+#include <cstddef>
+#include <vector>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+
+namespace uscheme {
+
+    class object_ptr;
+    struct object;
+
+    /**
+     * Registers an object_ptr owned by C++ code as a collector root for the
+     * lifetime of the guard. The slot may be reassigned freely while rooted.
+     *
+     *     uscheme::object_ptr p;
+     *     uscheme::gc_root guard(p);
+     */
+    class USCHEME_API gc_root
+    {
+      public:
+        explicit gc_root(object_ptr& slot);
+
+        ~gc_root();
+
+        object_ptr& slot() const { return *slot_; }
+
+      private:
+        gc_root(const gc_root&) = delete;
+        gc_root& operator=(const gc_root&) = delete;
+
+        friend class heap;
+
+        object_ptr* slot_;
+        gc_root*    prev_;
+        gc_root*    next_;
+    };
+
+    /**
+     * Collector counters. Pause times are wall clock nanoseconds.
+     */
+    struct gc_stats
+    {
+        size_t collections;
+        size_t objects_live;
+        size_t bytes_live;
+        size_t objects_freed;
+        size_t bytes_allocated;
+        size_t minor_collections;
+        size_t bytes_promoted;
+        size_t minor_pause_ns;
+        size_t minor_pause_max_ns;
+        size_t major_pause_ns;
+    };
+
+    /**
+     * The young generation. New cells are bump allocated from [top, limit);
+     * survivors are copied out by the minor collector. Exposed only so that
+     * gc_allocate() and the write barrier can be inlined; the collector owns
+     * every field.
+     */
+    struct gc_nursery
+    {
+        char* top;
+        char* limit;
+        char* base;
+        char* end;
+    };
+
+    extern USCHEME_API gc_nursery GC_NURSERY;
+
+    static const size_t GC_ALIGN = 8;
+
+    USCHEME_API
+    /**
+     * Allocation path taken when the nursery cannot fit size bytes.
+     */
+    void* gc_allocate_slow(size_t size);
+
+    /**
+     * Allocate an uninitialized heap cell of size bytes. Allocation never
+     * triggers a collection; objects only die at a collection call or
+     * gc_safepoint(), and only if unreachable from a gc_root. Young cells
+     * move when they survive a collection, which updates every gc_root and
+     * every reference held by a reachable cell.
+     */
+    USCHEME_INLINE
+    void* gc_allocate(size_t size)
+    {
+        size = (size + GC_ALIGN - 1) & ~(GC_ALIGN - 1);
+        char* p = GC_NURSERY.top;
+        if (static_cast<size_t>(GC_NURSERY.limit - p) >= size) {
+            GC_NURSERY.top = p + size;
+            return p;
+        }
+        return gc_allocate_slow(size);
+    }
+
+    /**
+     * Is the cell at p in the young generation?
+     */
+    USCHEME_INLINE
+    bool gc_is_young(const void* p)
+    {
+        const char* c = static_cast<const char*>(p);
+        return (c >= GC_NURSERY.base) && (c < GC_NURSERY.end);
+    }
+
+    USCHEME_API
+    /**
+     * Add an old cell that now references a young one to the remembered
+     * set. Called through gc_write_barrier().
+     */
+    void gc_remember(object* owner);
+
+    USCHEME_API
+    /**
+     * Mark everything reachable from the registered roots and sweep the rest.
+     * Runs a minor collection first, so this also empties the nursery.
+     */
+    void collect_garbage(void);
+
+    USCHEME_API
+    /**
+     * Copy the young cells reachable from the roots and the remembered set
+     * into the old generation and reset the nursery.
+     */
+    void collect_young_garbage(void);
+
+    USCHEME_API
+    /**
+     * Collect if enough has been allocated since the last collection. Call
+     * at points where every live object is reachable from a gc_root.
+     */
+    void gc_safepoint(void);
+
+    USCHEME_API
+    /**
+     * Get the current collector counters.
+     */
+    gc_stats gc_statistics(void);
+
+    /**
+     * Cells allocated by a helper thread while the owner of the heap waits
+     * in a gc_parallel_scope. Cells are taken from the arena installed on
+     * the allocating thread by a gc_arena_scope; they join the old
+     * generation when the owner calls gc_adopt(), and are freed with the
+     * arena otherwise.
+     */
+    class USCHEME_API gc_arena
+    {
+      public:
+        gc_arena();
+
+        ~gc_arena();
+
+      private:
+        gc_arena(const gc_arena&) = delete;
+        gc_arena& operator=(const gc_arena&) = delete;
+
+        friend class heap;
+        friend void* gc_allocate_slow(size_t size);
+
+        void* allocate(size_t size);
+
+        std::vector<object*> cells_;
+        size_t               bytes_;
+    };
+
+    /**
+     * Installs an arena for allocations made on the current thread for the
+     * lifetime of the guard.
+     */
+    class USCHEME_API gc_arena_scope
+    {
+      public:
+        explicit gc_arena_scope(gc_arena& arena);
+
+        ~gc_arena_scope();
+
+      private:
+        gc_arena_scope(const gc_arena_scope&) = delete;
+        gc_arena_scope& operator=(const gc_arena_scope&) = delete;
+
+        gc_arena* prev_;
+    };
+
+    /**
+     * Closes the nursery for the lifetime of the guard, so that threads
+     * allocating from their own gc_arena never bump the shared nursery.
+     * Held by the owner of the heap, which must not allocate outside an
+     * arena or collect while it is open.
+     */
+    class USCHEME_API gc_parallel_scope
+    {
+      public:
+        gc_parallel_scope();
+
+        ~gc_parallel_scope();
+
+      private:
+        gc_parallel_scope(const gc_parallel_scope&) = delete;
+        gc_parallel_scope& operator=(const gc_parallel_scope&) = delete;
+    };
+
+    USCHEME_API
+    /**
+     * Move the cells of an arena into the old generation. Called by the
+     * owner of the heap once the thread that filled the arena is done.
+     */
+    void gc_adopt(gc_arena& arena);
+
+}//namespace uscheme
+
+#endif//USCHEME_GC_HEAP_HPP
@@ -0,0 +1,165 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file slab.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if USCHEME_HUGE_PAGES && defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+// PKG includes
+#include <uscheme/gc/slab.hpp>
+
+namespace uscheme {
+
+    /* cells of class c are (c + 1) * CLASS_GRANULE bytes */
+    static const size_t CLASS_GRANULE = 16;
+    static const size_t NUM_CLASSES = SLAB_MAX_SIZE / CLASS_GRANULE;
+    /* slabs are carved from arena chunks; a slab holds cells of one class */
+    static const size_t SLAB_SIZE = 1 << 16;
+    static const size_t CHUNK_SIZE = 1 << 21;
+
+    struct free_cell
+    {
+        free_cell* next;
+    };
+
+    /**
+     * Per thread allocation state. Kept trivially destructible so that cells
+     * can still be freed during static destruction; cells cached by a thread
+     * that exits are not reused.
+     */
+    struct thread_cache
+    {
+        free_cell* free[NUM_CLASSES];
+        char*      top[NUM_CLASSES];
+        char*      end[NUM_CLASSES];
+    };
+
+    static thread_local thread_cache CACHE;
+
+    static std::mutex ARENA_LOCK;
+    static char*      ARENA_TOP = nullptr;
+    static char*      ARENA_END = nullptr;
+
+    static char* allocate_chunk()
+    {
+#if USCHEME_HUGE_PAGES && defined(__linux__)
+        /* over-map so the chunk can be aligned to a huge page boundary */
+        char* p = static_cast<char*>(mmap(nullptr, 2 * CHUNK_SIZE,
+                                          PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        char* chunk = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(p) + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1));
+        if (chunk != p) {
+            munmap(p, chunk - p);
+        }
+        munmap(chunk + CHUNK_SIZE, (p + 2 * CHUNK_SIZE) - (chunk + CHUNK_SIZE));
+        madvise(chunk, CHUNK_SIZE, MADV_HUGEPAGE);
+        return chunk;
+#else
+        char* chunk = static_cast<char*>(malloc(CHUNK_SIZE));
+        if (!chunk) {
+            throw std::bad_alloc();
+        }
+        return chunk;
+#endif
+    }
+
+    static char* allocate_slab()
+    {
+        std::lock_guard<std::mutex> lock(ARENA_LOCK);
+        if (ARENA_TOP == ARENA_END) {
+            ARENA_TOP = allocate_chunk();
+            ARENA_END = ARENA_TOP + CHUNK_SIZE;
+        }
+        char* slab = ARENA_TOP;
+        ARENA_TOP += SLAB_SIZE;
+        return slab;
+    }
+
+    static USCHEME_INLINE
+    size_t size_class(size_t size)
+    {
+        return (size == 0) ? 0 : (size - 1) / CLASS_GRANULE;
+    }
+
+    void* slab_allocate(size_t size)
+    {
+        if (size > SLAB_MAX_SIZE) {
+            void* p = malloc(size);
+            if (!p) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+
+        const size_t c = size_class(size);
+        thread_cache& tc = CACHE;
+
+        free_cell* f = tc.free[c];
+        if (f) {
+            tc.free[c] = f->next;
+            return f;
+        }
+
+        const size_t cell = (c + 1) * CLASS_GRANULE;
+        if (static_cast<size_t>(tc.end[c] - tc.top[c]) < cell) {
+            tc.top[c] = allocate_slab();
+            tc.end[c] = tc.top[c] + SLAB_SIZE;
+        }
+        char* p = tc.top[c];
+        tc.top[c] += cell;
+        return p;
+    }
+
+    void slab_free(void* p, size_t size)
+    {
+        if (size > SLAB_MAX_SIZE) {
+            free(p);
+            return;
+        }
+
+        const size_t c = size_class(size);
+        thread_cache& tc = CACHE;
+
+        free_cell* f = static_cast<free_cell*>(p);
+        f->next = tc.free[c];
+        tc.free[c] = f;
+    }
+
+}//namespace uscheme
@@ -0,0 +1,64 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file slab.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_GC_SLAB_HPP
+#define USCHEME_GC_SLAB_HPP
+
+// LANG includes
+#include <cstddef>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+
+namespace uscheme {
+
+    /**
+     * Largest request served from a slab. Larger ones go to malloc.
+     */
+    static const size_t SLAB_MAX_SIZE = 256;
+
+    USCHEME_API
+    /**
+     * Allocate size bytes from the slab of its size class. Each thread keeps
+     * its own free list per class, so the common case takes no lock.
+     * Throws std::bad_alloc.
+     */
+    void* slab_allocate(size_t size);
+
+    USCHEME_API
+    /**
+     * Return p, obtained from slab_allocate(size), to the free list of its
+     * size class. size must match the allocation request.
+     */
+    void slab_free(void* p, size_t size);
+
+}//namespace uscheme
+
+#endif//USCHEME_GC_SLAB_HPP
@@ -34,14 +34,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <uscheme/defs.hpp>
 #include <uscheme/stream/stream.hpp>
 #include <uscheme/exec/exec.hpp>
+#include <uscheme/gc/heap.hpp>
 
 void usage(void)
 {
     std::cout <<
     "\n"
-    "usage: scheme [-h]\n"
+    "usage: scheme [-h] [file]\n"
     "\n"
-    "Scheme interpreter using libuscheme.\n"
+    "Scheme interpreter using libuscheme. Loads file if given, otherwise\n"
+    "reads expressions from standard input.\n"
     "\n"
     "libuscheme version: " << uscheme::version() << "\n" <<
     "\n";
@@ -57,23 +59,27 @@ template <bool print = true>
 void repl(std::istream& strm)
 {
     std::cout << "Welcome to uscheme. Use Ctrl-C to exit.\n";
+
+    uscheme::object_ptr p;
+    uscheme::gc_root p_root(p);
+
     for (;;) {
+        uscheme::gc_safepoint();
+
       if (print) {
         std::cout << "> ";
       }
 
-        uscheme::object_ptr p;
-      try {
-        p = uscheme::read_object(strm);
-      } catch (const uscheme::exception& ex) {
-        if (ex.id() == uscheme::ERR_EOS) {
+        const uscheme::read_result result = uscheme::try_read_object(strm);
+        if (result.status == uscheme::READ_EOS) {
             exit(0);
-        } else {
+        }
+        if (result.status == uscheme::READ_ERROR) {
             uscheme::skip_line(strm);
+            std::cerr << "ERROR: " << uscheme::error_string(result.error) << '\n';
+            continue;
         }
-        std::cerr << "ERROR: " << ex.what() << '\n';
-        continue;
-      }
+        p = result.object;
 
         p = uscheme::eval_object(p);
 
@@ -93,10 +99,15 @@ int main(int argc, const char* argv[])
         }
         case 2: {
             std::string arg1(argv[1]);
-            if (arg1 != "-h") {
-                usage_and_die();
-            } else {
+            if (arg1 == "-h") {
                 usage();
+                break;
+            }
+            try {
+                uscheme::load_file(argv[1]);
+            } catch (const uscheme::exception& ex) {
+                std::cerr << "ERROR: " << ex.what() << '\n';
+                exit(1);
             }
             break;
         }
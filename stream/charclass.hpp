@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file charclass.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_CHARCLASS_HPP
+#define USCHEME_STREAM_CHARCLASS_HPP
+
+// LANG includes
+#include <cstdint>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+
+namespace uscheme {
+
+    /**
+     * Lexical classes of a byte, as bits of CHAR_CLASS. The classes are
+     * ASCII only and do not depend on the process locale. Byte 0xff is a
+     * delimiter because the reader uses it to mark the end of input.
+     */
+    enum char_class_bits
+    {
+        CHAR_SPACE      = 0x01, /* ' ', '\t' through '\r' */
+        CHAR_DELIMITER  = 0x02, /* whitespace, ( ) " ; and the end mark */
+        CHAR_DIGIT      = 0x04, /* 0-9 */
+        CHAR_SIGN       = 0x08, /* + - */
+        CHAR_INITIAL    = 0x10, /* starts an identifier */
+        CHAR_SUBSEQUENT = 0x20  /* continues an identifier */
+    };
+
+    constexpr bool char_in(const char* set, unsigned c)
+    {
+        return (*set != '\0') &&
+            ((static_cast<unsigned char>(*set) == c) || char_in(set + 1, c));
+    }
+
+    constexpr uint8_t classify_char(unsigned c)
+    {
+        return static_cast<uint8_t>(
+            (((c == ' ') || ((c >= '\t') && (c <= '\r'))) ? (CHAR_SPACE | CHAR_DELIMITER) : 0) |
+            ((char_in("()\";", c) || (c == 0xff)) ? CHAR_DELIMITER : 0) |
+            (((c >= '0') && (c <= '9')) ? (CHAR_DIGIT | CHAR_SUBSEQUENT) : 0) |
+            (char_in("+-", c) ? (CHAR_SIGN | CHAR_SUBSEQUENT) : 0) |
+            ((((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+              char_in("!$%&*/:<=>?^_~", c)) ? (CHAR_INITIAL | CHAR_SUBSEQUENT) : 0) |
+            (char_in(".@", c) ? CHAR_SUBSEQUENT : 0));
+    }
+
+#define USCHEME_CLASS4(n)  classify_char(n), classify_char(n + 1), \
+                           classify_char(n + 2), classify_char(n + 3)
+#define USCHEME_CLASS16(n) USCHEME_CLASS4(n), USCHEME_CLASS4(n + 4), \
+                           USCHEME_CLASS4(n + 8), USCHEME_CLASS4(n + 12)
+#define USCHEME_CLASS64(n) USCHEME_CLASS16(n), USCHEME_CLASS16(n + 16), \
+                           USCHEME_CLASS16(n + 32), USCHEME_CLASS16(n + 48)
+
+    constexpr uint8_t CHAR_CLASS[256] = {
+        USCHEME_CLASS64(0u), USCHEME_CLASS64(64u),
+        USCHEME_CLASS64(128u), USCHEME_CLASS64(192u)
+    };
+
+#undef USCHEME_CLASS64
+#undef USCHEME_CLASS16
+#undef USCHEME_CLASS4
+
+    static_assert(CHAR_CLASS[static_cast<unsigned char>('\n')] == (CHAR_SPACE | CHAR_DELIMITER),
+                  "newline is whitespace");
+    static_assert(CHAR_CLASS[static_cast<unsigned char>('7')] == (CHAR_DIGIT | CHAR_SUBSEQUENT),
+                  "digits continue identifiers");
+    static_assert(CHAR_CLASS[0x80] == 0, "non-ASCII bytes have no class");
+
+    static USCHEME_INLINE
+    bool char_is(char ch, unsigned bits)
+    {
+        return (CHAR_CLASS[static_cast<unsigned char>(ch)] & bits) != 0;
+    }
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_CHARCLASS_HPP
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file decimal.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_DECIMAL_HPP
+#define USCHEME_STREAM_DECIMAL_HPP
+
+// LANG includes
+#include <cstddef>
+#include <cstdint>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+
+namespace uscheme {
+
+    /**
+     * The value of ch as a digit of radix up to 16, in either case, or 16
+     * if it is not a hexadecimal digit.
+     */
+    USCHEME_INLINE
+    unsigned digit_value(char ch)
+    {
+        const unsigned c = static_cast<unsigned char>(ch);
+        if (c - '0' < 10) {
+            return c - '0';
+        }
+        if ((c | 0x20) - 'a' < 6) {
+            return (c | 0x20) - 'a' + 10;
+        }
+        return 16;
+    }
+
+    USCHEME_API
+    /**
+     * Accumulate the digits of radix (2, 8, 10 or 16) at the start of
+     * [begin, end) into *value, most significant first. Stops at the first
+     * byte that is not such a digit, or at the digit that would take *value
+     * past UINT64_MAX, and returns where it stopped. Decimal digits are
+     * taken eight at a time where eight bytes can be loaded.
+     */
+    const char* parse_digits(const char* begin, const char* end, unsigned radix,
+                             uint64_t* value);
+
+    USCHEME_API
+    /**
+     * Convert the decimal [sign] digits [. digits] [(e|E) [sign] digits],
+     * which must span exactly [begin, end), to the nearest double. Returns
+     * false if the span is not of that form.
+     */
+    bool parse_double(const char* begin, const char* end, double* value);
+
+    /**
+     * Large enough for the output of format_integer and format_double.
+     */
+    static const size_t FORMAT_BUFFER_SIZE = 32;
+
+    USCHEME_API
+    /**
+     * Write the decimal digits of value, with a leading '-' if negative, to
+     * out. Returns the number of characters written; no terminator is added.
+     */
+    size_t format_integer(long value, char* out);
+
+    USCHEME_API
+    /**
+     * Write the shortest decimal that reads back as value to out, always
+     * with a point or an exponent; infinities and NaNs are written as
+     * +inf.0, -inf.0 and +nan.0. Returns the number of characters written;
+     * no terminator is added.
+     */
+    size_t format_double(double value, char* out);
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_DECIMAL_HPP
@@ -0,0 +1,510 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file fasl.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <algorithm>
+#include <cstring>
+
+// PKG includes
+#include <uscheme/stream/fasl.hpp>
+
+#define ERROR_IF(cond, id)        \
+ if ((cond)) {                    \
+    throw uscheme::exception(id); \
+ }
+
+/* inside the reader errors are returned, not thrown; see fail() */
+#define FAIL_IF(cond, id)         \
+ if ((cond)) {                    \
+    return fail((id));            \
+ }
+
+namespace uscheme {
+
+    /* the last byte is the format version */
+    static const char FASL_HEADER[8] = { '\x7f', 'u', 's', 'f', 'a', 's', 'l', '\x01' };
+
+    enum fasl_tag
+    {
+        FASL_FALSE,
+        FASL_TRUE,
+        FASL_EMPTY_LIST,
+        FASL_CHARACTER,  /* byte */
+        FASL_FIXNUM,     /* zigzag varint */
+        FASL_SYMBOL,     /* varint length, name; a new table entry */
+        FASL_SYMBOL_REF, /* varint index in the symbol table */
+        FASL_STRING,     /* varint length, contents; a new table entry */
+        FASL_STRING_REF, /* varint index in the string table */
+        FASL_PAIR,       /* car, cdr */
+        FASL_VECTOR,     /* varint length, elements */
+        FASL_FLONUM,     /* 8 bytes */
+        FASL_BIGNUM,     /* sign byte, varint length, 4 bytes a digit */
+        FASL_REF,        /* varint index of an earlier cell of the record */
+        FASL_LIST        /* varint length n, n cars, the cdr of the last pair */
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // fasl_writer
+    //////////////////////////////////////////////////////////////////////////
+
+    fasl_writer::fasl_writer(std::ostream& os)
+      : os_(os)
+      , out_(FASL_HEADER, sizeof(FASL_HEADER))
+    { }
+
+    fasl_writer::~fasl_writer()
+    {
+        flush();
+    }
+
+    void fasl_writer::flush()
+    {
+        os_.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+        out_.clear();
+    }
+
+    void fasl_writer::put_varint(uint64_t value)
+    {
+        while (value >= 0x80) {
+            put(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        put(static_cast<uint8_t>(value));
+    }
+
+    void fasl_writer::put_symbol(const object_ptr& p)
+    {
+        const auto found = symbols_.find(p.symbol_name());
+        if (found != symbols_.end()) {
+            put(FASL_SYMBOL_REF);
+            put_varint(found->second);
+            return;
+        }
+        symbols_.emplace(p.symbol_name(), static_cast<uint32_t>(symbols_.size()));
+        put(FASL_SYMBOL);
+        put_varint(p.symbol_length());
+        out_.append(p.symbol_name(), p.symbol_length());
+    }
+
+    void fasl_writer::put_string(const object_ptr& p)
+    {
+        key_.assign(p->string(), p->string_length());
+        const auto found = strings_.find(key_);
+        if (found != strings_.end()) {
+            put(FASL_STRING_REF);
+            put_varint(found->second);
+            return;
+        }
+        strings_.emplace(key_, static_cast<uint32_t>(strings_.size()));
+        put(FASL_STRING);
+        put_varint(key_.size());
+        out_.append(key_);
+    }
+
+    void fasl_writer::write(const object_ptr& p)
+    {
+        /* nothing is allocated while writing, so cells stay where they are */
+        refs_.clear();
+        stack_.clear();
+        stack_.push_back(p);
+        while (!stack_.empty()) {
+            const object_ptr q = stack_.back();
+            stack_.pop_back();
+
+            if (q.is_heap()) {
+                const auto ref = refs_.emplace(q.get(), static_cast<uint32_t>(refs_.size()));
+                if (!ref.second) {
+                    put(FASL_REF);
+                    put_varint(ref.first->second);
+                    continue;
+                }
+            }
+
+            switch (q.type()) {
+                case BOOLEAN: {
+                    put(q.boolean() ? FASL_TRUE : FASL_FALSE);
+                    break;
+                }
+                case CHARACTER: {
+                    put(FASL_CHARACTER);
+                    put(static_cast<uint8_t>(q.character()));
+                    break;
+                }
+                case FIXNUM: {
+                    const uint64_t n = static_cast<uint64_t>(q.fixnum());
+                    put(FASL_FIXNUM);
+                    put_varint((n << 1) ^ ((q.fixnum() < 0) ? ~uint64_t(0) : 0));
+                    break;
+                }
+                case EMPTY_LIST: {
+                    put(FASL_EMPTY_LIST);
+                    break;
+                }
+                case SYMBOL: {
+                    put_symbol(q);
+                    break;
+                }
+                case STRING: {
+                    put_string(q);
+                    break;
+                }
+                case PAIR: {
+                    /* the pairs of a list not met before go out together */
+                    chain_.clear();
+                    chain_.push_back(q);
+                    object_ptr tail = q->cdr();
+                    while (tail.is_pair() &&
+                           refs_.emplace(tail.get(), static_cast<uint32_t>(refs_.size())).second) {
+                        chain_.push_back(tail);
+                        tail = tail->cdr();
+                    }
+                    if (chain_.size() == 1) {
+                        put(FASL_PAIR);
+                    } else {
+                        put(FASL_LIST);
+                        put_varint(chain_.size());
+                    }
+                    stack_.push_back(tail);
+                    for (size_t i = chain_.size(); i != 0; --i) {
+                        stack_.push_back(chain_[i - 1]->car());
+                    }
+                    break;
+                }
+                case VECTOR: {
+                    const size_t n = q.vector_length();
+                    put(FASL_VECTOR);
+                    put_varint(n);
+                    for (size_t i = n; i != 0; --i) {
+                        stack_.push_back(q.vector_ref(i - 1));
+                    }
+                    break;
+                }
+                case FLONUM: {
+                    const double value = q.flonum();
+                    uint64_t bits;
+                    memcpy(&bits, &value, sizeof(bits));
+                    put(FASL_FLONUM);
+                    for (int i = 0; i != 8; ++i) {
+                        put(static_cast<uint8_t>(bits >> (8 * i)));
+                    }
+                    break;
+                }
+                case BIGNUM: {
+                    const uint32_t* digits = q.bignum_digits();
+                    const size_t length = q.bignum_length();
+                    put(FASL_BIGNUM);
+                    put(q.bignum_negative() ? 1 : 0);
+                    put_varint(length);
+                    for (size_t i = 0; i != length; ++i) {
+                        for (int j = 0; j != 4; ++j) {
+                            put(static_cast<uint8_t>(digits[i] >> (8 * j)));
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (out_.size() >= FLUSH_SIZE) {
+            flush();
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // fasl_reader
+    //////////////////////////////////////////////////////////////////////////
+
+    fasl_reader::fasl_reader(const char* begin, const char* end)
+      : base_(begin)
+      , cur_(begin)
+      , end_(end)
+      , sb_(nullptr)
+      , failed_(false)
+      , error_(ERR_EOS)
+    {
+        ERROR_IF(!available(sizeof(FASL_HEADER)) ||
+                 (memcmp(cur_, FASL_HEADER, sizeof(FASL_HEADER)) != 0), ERR_FASL_HDR);
+        cur_ += sizeof(FASL_HEADER);
+    }
+
+    fasl_reader::fasl_reader(std::istream& s)
+      : base_(nullptr)
+      , cur_(nullptr)
+      , end_(nullptr)
+      , sb_(s.rdbuf())
+      , failed_(false)
+      , error_(ERR_EOS)
+    {
+        ERROR_IF(!available(sizeof(FASL_HEADER)) ||
+                 (memcmp(cur_, FASL_HEADER, sizeof(FASL_HEADER)) != 0), ERR_FASL_HDR);
+        cur_ += sizeof(FASL_HEADER);
+    }
+
+    /* at least n bytes at cur_, moving what is left to the front of the
+       buffer and reading whole chunks after it. The buffer only grows as
+       bytes arrive, so a length read from a corrupt stream costs no more
+       memory than the stream holds. */
+    bool fasl_reader::refill(size_t n)
+    {
+        if (!sb_) {
+            return false;
+        }
+        const size_t kept = static_cast<size_t>(end_ - cur_);
+        if (kept && (cur_ != buffer_.data())) {
+            memmove(buffer_.data(), cur_, kept);
+        }
+        if (buffer_.size() < CHUNK_SIZE) {
+            buffer_.resize(CHUNK_SIZE);
+        }
+        size_t got = kept;
+        while (got < n) {
+            if (got == buffer_.size()) {
+                buffer_.resize(2 * buffer_.size());
+            }
+            const std::streamsize more = sb_->sgetn(buffer_.data() + got,
+                                                    static_cast<std::streamsize>(buffer_.size() - got));
+            if (more <= 0) {
+                break;
+            }
+            got += static_cast<size_t>(more);
+        }
+        cur_ = buffer_.data();
+        end_ = cur_ + got;
+        return got >= n;
+    }
+
+    bool fasl_reader::get_varint(uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!available(1)) {
+                return false;
+            }
+            const uint8_t byte = static_cast<uint8_t>(*cur_++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* record why reading stopped; the caller returns at once */
+    object_ptr fasl_reader::fail(except_id id)
+    {
+        failed_ = true;
+        error_ = id;
+        return object_ptr();
+    }
+
+    object_ptr fasl_reader::read_record()
+    {
+        FAIL_IF(!available(1), ERR_EOS);
+
+        /* nothing is collected while a record is read, so refs_ and
+           holes_ can hold cells without rooting them */
+        object_ptr result;
+        refs_.clear();
+        holes_.clear();
+        holes_.push_back(hole{ object_ptr(), 0 });
+        while (!holes_.empty()) {
+            const hole h = holes_.back();
+            holes_.pop_back();
+
+            FAIL_IF(!available(1), ERR_FASL_DATA);
+            const uint8_t tag = static_cast<uint8_t>(*cur_++);
+            uint64_t n = 0;
+            object_ptr v;
+            switch (tag) {
+                case FASL_FALSE: {
+                    v = false_value();
+                    break;
+                }
+                case FASL_TRUE: {
+                    v = true_value();
+                    break;
+                }
+                case FASL_EMPTY_LIST: {
+                    v = empty_list_value();
+                    break;
+                }
+                case FASL_CHARACTER: {
+                    FAIL_IF(!available(1), ERR_FASL_DATA);
+                    v = object::create_character(*cur_++);
+                    break;
+                }
+                case FASL_FIXNUM: {
+                    FAIL_IF(!get_varint(n), ERR_FASL_DATA);
+                    const long value = static_cast<long>((n >> 1) ^ (~(n & 1) + 1));
+                    FAIL_IF((value < object_ptr::FIXNUM_MIN) || (value > object_ptr::FIXNUM_MAX),
+                            ERR_FASL_DATA);
+                    v = object::create_fixnum(value);
+                    break;
+                }
+                case FASL_SYMBOL: {
+                    FAIL_IF(!get_varint(n) || !available(n), ERR_FASL_DATA);
+                    v = object::create_symbol(cur_, n);
+                    cur_ += n;
+                    symbols_.push_back(v);
+                    break;
+                }
+                case FASL_SYMBOL_REF: {
+                    FAIL_IF(!get_varint(n) || (n >= symbols_.size()), ERR_FASL_DATA);
+                    v = symbols_[n];
+                    break;
+                }
+                case FASL_STRING: {
+                    FAIL_IF(!get_varint(n) || !available(n), ERR_FASL_DATA);
+                    entry e = { static_cast<size_t>(cur_ - base_), n };
+                    if (sb_) {
+                        /* the buffer is reused, so streams keep their own copy */
+                        e.offset = storage_.size();
+                        storage_.append(cur_, n);
+                    }
+                    strings_.push_back(e);
+                    v = object::create_string(cur_, n);
+                    cur_ += n;
+                    refs_.push_back(v);
+                    break;
+                }
+                case FASL_STRING_REF: {
+                    FAIL_IF(!get_varint(n) || (n >= strings_.size()), ERR_FASL_DATA);
+                    const entry& e = strings_[n];
+                    v = object::create_string((sb_ ? storage_.data() : base_) + e.offset, e.length);
+                    refs_.push_back(v);
+                    break;
+                }
+                case FASL_PAIR: {
+                    v = object::create_pair(empty_list_value(), empty_list_value());
+                    refs_.push_back(v);
+                    holes_.push_back(hole{ v, 1 });
+                    holes_.push_back(hole{ v, 0 });
+                    break;
+                }
+                case FASL_LIST: {
+                    /* every car takes a byte at least */
+                    FAIL_IF(!get_varint(n) || (n < 2) || !available(n), ERR_FASL_DATA);
+                    const size_t first = refs_.size();
+                    v = object::create_pair(empty_list_value(), empty_list_value());
+                    refs_.push_back(v);
+                    for (size_t i = 1; i != n; ++i) {
+                        const object_ptr next = object::create_pair(empty_list_value(),
+                                                                    empty_list_value());
+                        refs_.back().set_cdr(next);
+                        refs_.push_back(next);
+                    }
+                    holes_.push_back(hole{ refs_.back(), 1 });
+                    for (size_t i = n; i != 0; --i) {
+                        holes_.push_back(hole{ refs_[first + i - 1], 0 });
+                    }
+                    break;
+                }
+                case FASL_VECTOR: {
+                    /* every element takes a byte at least */
+                    FAIL_IF(!get_varint(n) || !available(n), ERR_FASL_DATA);
+                    v = object::create_vector(n, empty_list_value());
+                    refs_.push_back(v);
+                    for (size_t i = n; i != 0; --i) {
+                        holes_.push_back(hole{ v, i - 1 });
+                    }
+                    break;
+                }
+                case FASL_FLONUM: {
+                    FAIL_IF(!available(8), ERR_FASL_DATA);
+                    uint64_t bits = 0;
+                    for (int i = 0; i != 8; ++i) {
+                        bits |= static_cast<uint64_t>(static_cast<uint8_t>(cur_[i])) << (8 * i);
+                    }
+                    cur_ += 8;
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+                    v = object::create_flonum(value);
+                    refs_.push_back(v);
+                    break;
+                }
+                case FASL_BIGNUM: {
+                    FAIL_IF(!available(1), ERR_FASL_DATA);
+                    const uint8_t negative = static_cast<uint8_t>(*cur_++);
+                    FAIL_IF((negative > 1) || !get_varint(n) || (n == 0) || (n > SIZE_MAX / 4) ||
+                            !available(4 * n), ERR_FASL_DATA);
+                    digits_.resize(n);
+                    for (size_t i = 0; i != n; ++i) {
+                        const uint8_t* d = reinterpret_cast<const uint8_t*>(cur_ + 4 * i);
+                        digits_[i] = d[0] | (uint32_t(d[1]) << 8) | (uint32_t(d[2]) << 16) |
+                                     (uint32_t(d[3]) << 24);
+                    }
+                    cur_ += 4 * n;
+                    FAIL_IF(digits_[n - 1] == 0, ERR_FASL_DATA);
+                    v = object::create_bignum(negative != 0, digits_.data(), n);
+                    refs_.push_back(v);
+                    break;
+                }
+                case FASL_REF: {
+                    FAIL_IF(!get_varint(n) || (n >= refs_.size()), ERR_FASL_DATA);
+                    v = refs_[n];
+                    break;
+                }
+                default: {
+                    return fail(ERR_FASL_DATA);
+                }
+            }
+
+            if (!h.owner.is_heap()) {
+                result = v;
+            } else if (h.owner.is_pair()) {
+                if (h.slot == 0) {
+                    h.owner.set_car(v);
+                } else {
+                    h.owner.set_cdr(v);
+                }
+            } else {
+                h.owner.vector_set(h.slot, v);
+            }
+        }
+        return result;
+    }
+
+    read_result fasl_reader::try_read()
+    {
+        read_result result;
+        result.object = failed_ ? object_ptr() : read_record();
+        result.status = !failed_ ? READ_OBJECT : (error_ == ERR_EOS) ? READ_EOS : READ_ERROR;
+        result.error = error_;
+        return result;
+    }
+
+    object_ptr fasl_reader::read()
+    {
+        const read_result result = try_read();
+        ERROR_IF((result.status != READ_OBJECT), result.error);
+        return result.object;
+    }
+
+}//namespace uscheme
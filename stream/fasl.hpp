@@ -0,0 +1,197 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file fasl.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_FASL_HPP
+#define USCHEME_STREAM_FASL_HPP
+
+// LANG includes
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/except.hpp>
+#include <uscheme/type/object.hpp>
+#include <uscheme/stream/stream.hpp>
+
+namespace uscheme {
+
+    /**
+     * Writes objects in the binary fasl ("fast load") format, for caching
+     * data between runs without printing and re-reading text:
+     *
+     *     std::ofstream out("cache.fasl", std::ios::binary);
+     *     uscheme::fasl_writer w(out);
+     *     w.write(p);
+     *     w.write(q);
+     *
+     * A fasl stream is an 8 byte header followed by one record per object
+     * written. Records are byte oriented, with no alignment, and can be
+     * decoded in place from a mapped file:
+     *
+     *   - fixnums are zigzag varints, characters one byte, flonums their
+     *     8 bytes little endian and bignums a sign, a varint length and
+     *     little endian 32 bit digits;
+     *   - symbol names and string contents are length prefixed and go into
+     *     a table shared by every record of the stream, so each distinct
+     *     name or contents is written once and referred to by index after;
+     *   - pairs and vectors are written in prefix order, car before cdr,
+     *     the pairs along a list as one run of cars followed by its tail,
+     *     and a heap object met again within the record is written as a
+     *     reference to the first, so shared structure and cycles survive.
+     *
+     * Output is buffered; it is complete once flush() is called or the
+     * writer is destroyed.
+     */
+    class USCHEME_API fasl_writer
+    {
+      public:
+        explicit fasl_writer(std::ostream& os);
+
+        ~fasl_writer();
+
+        /**
+         * Append a record holding p.
+         */
+        void write(const object_ptr& p);
+
+        /**
+         * Hand everything written so far to the stream.
+         */
+        void flush();
+
+      private:
+        fasl_writer(const fasl_writer&) = delete;
+        fasl_writer& operator=(const fasl_writer&) = delete;
+
+        static const size_t FLUSH_SIZE = 64 * 1024;
+
+        void put(uint8_t byte) { out_.push_back(static_cast<char>(byte)); }
+        void put_varint(uint64_t value);
+        void put_symbol(const object_ptr& p);
+        void put_string(const object_ptr& p);
+
+        std::ostream&                             os_;
+        std::string                               out_;
+        std::unordered_map<const char*, uint32_t> symbols_; /* by interned name */
+        std::unordered_map<std::string, uint32_t> strings_; /* by contents */
+        std::unordered_map<const void*, uint32_t> refs_;    /* this record's cells */
+        std::vector<object_ptr>                   stack_;
+        std::vector<object_ptr>                   chain_;
+        std::string                               key_;
+    };
+
+    /**
+     * Reads the objects a fasl_writer wrote, in order, either in place from
+     * the bytes in [begin, end), which must stay put while the reader is
+     * used, or from a stream, which the reader then takes over to the end:
+     *
+     *     uscheme::fasl_reader r(begin, end);
+     *     uscheme::read_result result;
+     *     while ((result = r.try_read()).status == uscheme::READ_OBJECT) {
+     *         ...
+     *     }
+     *
+     * A stream that does not start with a fasl header throws ERR_FASL_HDR
+     * from the constructor; a malformed or truncated record is reported as
+     * ERR_FASL_DATA, after which the reader only reports that error.
+     */
+    class USCHEME_API fasl_reader
+    {
+      public:
+        fasl_reader(const char* begin, const char* end);
+
+        explicit fasl_reader(std::istream& s);
+
+        /**
+         * The next object; throws ERR_EOS after the last.
+         */
+        object_ptr read();
+
+        /**
+         * read without exceptions.
+         */
+        read_result try_read();
+
+      private:
+        fasl_reader(const fasl_reader&) = delete;
+        fasl_reader& operator=(const fasl_reader&) = delete;
+
+        static const size_t CHUNK_SIZE = 64 * 1024;
+
+        /* a place a value read next goes: slot 0 or 1 of a pair (car or
+           cdr), an element of a vector, or the result if owner is null */
+        struct hole
+        {
+            object_ptr owner;
+            size_t     slot;
+        };
+
+        /* a table entry: length bytes at offset in the input (in place)
+           or in storage_ (streams) */
+        struct entry
+        {
+            size_t offset;
+            size_t length;
+        };
+
+        bool available(size_t n)
+        {
+            return (static_cast<size_t>(end_ - cur_) >= n) || refill(n);
+        }
+
+        bool refill(size_t n);
+        bool get_varint(uint64_t& value);
+        object_ptr fail(except_id id);
+        object_ptr read_record();
+
+        const char*             base_; /* the start of in place input */
+        const char*             cur_;
+        const char*             end_;
+        std::streambuf*         sb_;
+        std::vector<char>       buffer_;
+        bool                    failed_;
+        except_id               error_;
+        std::string             storage_;
+        std::vector<entry>      strings_;
+        std::vector<object_ptr> symbols_; /* interned, so never moved */
+        std::vector<object_ptr> refs_;    /* this record's cells */
+        std::vector<hole>       holes_;
+        std::vector<uint32_t>   digits_;
+    };
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_FASL_HPP
@@ -0,0 +1,163 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file file.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <fstream>
+#include <vector>
+
+#if defined(_WIN32)
+#  include <iterator>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// PKG includes
+#include <uscheme/stream/file.hpp>
+#include <uscheme/stream/parallel.hpp>
+#include <uscheme/stream/fasl.hpp>
+
+#define ERROR_IF(cond, id)        \
+ if ((cond)) {                    \
+    throw uscheme::exception(id); \
+ }
+
+namespace uscheme {
+
+    /**
+     * The contents of a file for as long as it is in scope: a read-only
+     * private mapping, advised for one sequential pass, or a plain copy
+     * where mmap is not available.
+     */
+    class mapped_file
+    {
+      public:
+        explicit mapped_file(const char* path)
+          : data_(nullptr)
+          , size_(0)
+        {
+#if defined(_WIN32)
+            std::ifstream in(path, std::ios::binary);
+            ERROR_IF(!in, ERR_FILE_OPEN);
+            copy_.assign(std::istreambuf_iterator<char>(in),
+                         std::istreambuf_iterator<char>());
+            data_ = copy_.data();
+            size_ = copy_.size();
+#else
+            const int fd = open(path, O_RDONLY);
+            ERROR_IF((fd < 0), ERR_FILE_OPEN);
+            struct stat st;
+            if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode)) {
+                close(fd);
+                ERROR_IF(true, ERR_FILE_OPEN);
+            }
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ != 0) {
+                void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    close(fd);
+                    ERROR_IF(true, ERR_FILE_OPEN);
+                }
+                madvise(p, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(p);
+            }
+            close(fd);
+#endif
+        }
+
+        ~mapped_file()
+        {
+#if !defined(_WIN32)
+            if (data_) {
+                munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+        }
+
+        const char* begin() const { return data_; }
+        const char* end() const { return data_ + size_; }
+
+      private:
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        const char* data_;
+        size_t      size_;
+#if defined(_WIN32)
+        std::vector<char> copy_;
+#endif
+    };
+
+    object_ptr read_file(const char* path, unsigned threads)
+    {
+        const mapped_file file(path);
+        return read_objects(file.begin(), file.end(), threads);
+    }
+
+    object_ptr read_fasl_file(const char* path)
+    {
+        const mapped_file file(path);
+        fasl_reader r(file.begin(), file.end());
+
+        /* nothing is collected while reading, so the list needs no root */
+        object_ptr head = empty_list_value();
+        object_ptr tail;
+        while (true) {
+            const read_result result = r.try_read();
+            if (result.status == READ_EOS) {
+                break;
+            }
+            ERROR_IF((result.status == READ_ERROR), result.error);
+            const object_ptr cell = object::create_pair(result.object, empty_list_value());
+            if (tail.is_pair()) {
+                tail.set_cdr(cell);
+            } else {
+                head = cell;
+            }
+            tail = cell;
+        }
+        return head;
+    }
+
+    void write_fasl_file(const char* path, const object_ptr& list)
+    {
+        std::ofstream out(path, std::ios::binary);
+        ERROR_IF(!out, ERR_FILE_OPEN);
+        fasl_writer w(out);
+        for (object_ptr p = list; p.is_pair(); p = p->cdr()) {
+            w.write(p->car());
+        }
+        w.flush();
+        ERROR_IF(!out, ERR_FILE_OPEN);
+    }
+
+}//namespace uscheme
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file file.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_FILE_HPP
+#define USCHEME_STREAM_FILE_HPP
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/except.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    USCHEME_API
+    /**
+     * Read every object in the file at path, in order, into a list. The
+     * file is mapped read-only and parsed in place, by up to threads threads
+     * as in read_objects().
+     */
+    object_ptr read_file(const char* path, unsigned threads = 1);
+
+    USCHEME_API
+    /**
+     * Read every record of the fasl file at path, in order, into a list.
+     * The file is mapped read-only and decoded in place; see fasl.hpp.
+     */
+    object_ptr read_fasl_file(const char* path);
+
+    USCHEME_API
+    /**
+     * Write each object of list to the file at path as a fasl record, so
+     * that read_fasl_file() gives back an equal list.
+     */
+    void write_fasl_file(const char* path, const object_ptr& list);
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_FILE_HPP
@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file literal.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <algorithm>
+#include <cstring>
+
+// PKG includes
+#include <uscheme/stream/literal.hpp>
+
+namespace uscheme {
+
+    literal_table::literal_table()
+      : slots_(INITIAL_CAPACITY)
+      , count_(0)
+      , hits_(0)
+      , objects_(empty_list_value())
+      , objects_root_(objects_)
+    { }
+
+    void literal_table::key_of(const object_ptr& p, key& k)
+    {
+        k.type = p->type();
+        k.negative = false;
+        k.data = nullptr;
+        k.size = 0;
+        switch (k.type) {
+            case STRING:
+                k.data = p->string();
+                k.size = p->string_length();
+                break;
+            case FLONUM:
+                k.flonum = p->flonum();
+                k.data = &k.flonum;
+                k.size = sizeof(double);
+                break;
+            case BIGNUM:
+                k.negative = p->bignum_negative();
+                k.data = p->bignum_digits();
+                k.size = p->bignum_length() * sizeof(uint32_t);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /* FNV-1a over the contents, seeded by the type */
+    uint32_t literal_table::hash(const key& k)
+    {
+        uint32_t h = 2166136261u ^ (static_cast<uint32_t>(k.type) * 2 + k.negative);
+        const unsigned char* p = static_cast<const unsigned char*>(k.data);
+        for (size_t i = 0; i != k.size; ++i) {
+            h ^= p[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    bool literal_table::matches(uint32_t index, const key& k) const
+    {
+        key o;
+        key_of(objects_->vector_ref(index), o);
+        return (o.type == k.type) && (o.negative == k.negative) && (o.size == k.size) &&
+               (memcmp(o.data, k.data, k.size) == 0);
+    }
+
+    /* the slot holding k, or the free slot it would go in */
+    bool literal_table::find(const key& k, uint32_t h, size_t& i) const
+    {
+        const size_t mask = slots_.size() - 1;
+        for (i = h & mask; slots_[i].index; i = (i + 1) & mask) {
+            if ((slots_[i].hash == h) && matches(slots_[i].index - 1, k)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    object_ptr literal_table::add(size_t i, uint32_t h, const object_ptr& p)
+    {
+        const size_t capacity = objects_.is_vector() ? objects_->vector_length() : 0;
+        if (count_ == capacity) {
+            object_ptr bigger = object::create_vector(std::max<size_t>(2 * capacity, 64),
+                                                      empty_list_value());
+            for (size_t j = 0; j != count_; ++j) {
+                bigger->vector_set(j, objects_->vector_ref(j));
+            }
+            objects_ = bigger;
+        }
+        objects_->vector_set(count_, p);
+
+        slots_[i].hash = h;
+        slots_[i].index = static_cast<uint32_t>(++count_);
+        if (count_ * 2 > slots_.size()) {
+            resize(slots_.size() * 2);
+        }
+        return p;
+    }
+
+    void literal_table::resize(size_t capacity)
+    {
+        std::vector<slot> slots(capacity);
+        const size_t mask = capacity - 1;
+        for (size_t i = 0; i != slots_.size(); ++i) {
+            const slot& s = slots_[i];
+            if (s.index) {
+                size_t j = s.hash & mask;
+                while (slots[j].index) {
+                    j = (j + 1) & mask;
+                }
+                slots[j] = s;
+            }
+        }
+        slots_.swap(slots);
+    }
+
+    object_ptr literal_table::string(const char* value, size_t length)
+    {
+        const key k = { STRING, false, value, length, 0.0 };
+        const uint32_t h = hash(k);
+        size_t i;
+        if (find(k, h, i)) {
+            ++hits_;
+            return objects_->vector_ref(slots_[i].index - 1);
+        }
+        return add(i, h, object::create_string(value, length));
+    }
+
+    object_ptr literal_table::flonum(double value)
+    {
+        const key k = { FLONUM, false, &value, sizeof(double), value };
+        const uint32_t h = hash(k);
+        size_t i;
+        if (find(k, h, i)) {
+            ++hits_;
+            return objects_->vector_ref(slots_[i].index - 1);
+        }
+        return add(i, h, object::create_flonum(value));
+    }
+
+    object_ptr literal_table::share(const object_ptr& p)
+    {
+        if (!p.is_heap()) {
+            return p;
+        }
+        key k;
+        key_of(p, k);
+        if (!k.data) {
+            return p;
+        }
+        const uint32_t h = hash(k);
+        size_t i;
+        if (find(k, h, i)) {
+            ++hits_;
+            return objects_->vector_ref(slots_[i].index - 1);
+        }
+        return add(i, h, p);
+    }
+
+}//namespace uscheme
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file literal.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_LITERAL_HPP
+#define USCHEME_STREAM_LITERAL_HPP
+
+// LANG includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/gc/heap.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    /**
+     * Shares literals between the data a reader makes. A reader given a
+     * literal_table through reader_options::literals returns the object
+     * already in the table for each string, flonum and bignum it has seen
+     * before, so repeated literals take one cell and compare eq.
+     *
+     *     uscheme::literal_table literals;
+     *     uscheme::reader_options options;
+     *     options.literals = &literals;
+     *     uscheme::reader r(options);
+     *
+     * Literals are constants: a shared string must not be modified. The
+     * table keeps every object in it alive. With a source_map as well, a
+     * shared literal has the span of its first occurrence.
+     */
+    class USCHEME_API literal_table
+    {
+      public:
+        literal_table();
+
+        /**
+         * The number of distinct literals in the table.
+         */
+        size_t size() const { return count_; }
+
+        /**
+         * The number of times an existing literal was handed out.
+         */
+        size_t hits() const { return hits_; }
+
+        /**
+         * The string of length bytes at value.
+         */
+        object_ptr string(const char* value, size_t length);
+
+        /**
+         * The flonum with the bits of value.
+         */
+        object_ptr flonum(double value);
+
+        /**
+         * The literal equal to p, which is p itself if there was none yet.
+         * Objects that are not strings, flonums or bignums are returned as
+         * they are.
+         */
+        object_ptr share(const object_ptr& p);
+
+      private:
+        literal_table(const literal_table&) = delete;
+        literal_table& operator=(const literal_table&) = delete;
+
+        static const size_t INITIAL_CAPACITY = 1 << 8;
+
+        struct slot
+        {
+            uint32_t hash;
+            uint32_t index; /* in objects_, plus one; 0 if the slot is free */
+        };
+
+        /* the contents a literal is compared by */
+        struct key
+        {
+            object_type type;
+            bool        negative;
+            const void* data;
+            size_t      size;
+            double      flonum; /* data points here for flonums */
+        };
+
+        static void key_of(const object_ptr& p, key& k);
+        static uint32_t hash(const key& k);
+        bool matches(uint32_t index, const key& k) const;
+        bool find(const key& k, uint32_t h, size_t& i) const;
+        object_ptr add(size_t i, uint32_t h, const object_ptr& p);
+        void resize(size_t capacity);
+
+        std::vector<slot> slots_;
+        size_t            count_;
+        size_t            hits_;
+        object_ptr        objects_; /* vector of the literals */
+        gc_root           objects_root_;
+    };
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_LITERAL_HPP
@@ -0,0 +1,298 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file parallel.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// PKG includes
+#include <uscheme/gc/heap.hpp>
+#include <uscheme/stream/charclass.hpp>
+#include <uscheme/stream/parallel.hpp>
+#include <uscheme/stream/scan.hpp>
+#include <uscheme/stream/stream.hpp>
+
+#define ERROR_IF(cond, id)        \
+ if ((cond)) {                    \
+    throw uscheme::exception(id); \
+ }
+
+namespace uscheme {
+
+    /* below this many bytes per thread the split is not worth it */
+    static const size_t MIN_PIECE_SIZE = 64 * 1024;
+    /* bytes per thread when the caller leaves the count to us: each extra
+       thread also contends for the symbol table lock */
+    static const size_t AUTO_PIECE_SIZE = 1024 * 1024;
+    /* pieces per thread, so that a slow piece does not hold up the rest */
+    static const size_t PIECES_PER_THREAD = 4;
+
+    /**
+     * Threads kept for the life of the process and shared by every
+     * read_objects() call, so that thread start up is paid once and the
+     * slab caches the threads fill are reused.
+     */
+    class worker_pool
+    {
+      public:
+        worker_pool()
+          : threads_()
+          , job_(nullptr)
+          , active_(0)
+          , pending_(0)
+          , generation_(0)
+          , stop_(false)
+        { }
+
+        ~worker_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(lock_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (size_t i = 0; i != threads_.size(); ++i) {
+                threads_[i].join();
+            }
+        }
+
+        /* run job(i) for every i in [0, n), job(0) on the calling thread,
+           and wait for all of them; job must not throw */
+        void run(unsigned n, const std::function<void(unsigned)>& job)
+        {
+            std::lock_guard<std::mutex> serial(run_lock_);
+            {
+                std::lock_guard<std::mutex> lock(lock_);
+                while (threads_.size() + 1 < n) {
+                    const unsigned index = static_cast<unsigned>(threads_.size() + 1);
+                    threads_.emplace_back(&worker_pool::loop, this, index, generation_);
+                }
+                job_ = &job;
+                active_ = n;
+                pending_ = n - 1;
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            job(0);
+
+            std::unique_lock<std::mutex> lock(lock_);
+            done_.wait(lock, [this] { return pending_ == 0; });
+            job_ = nullptr;
+        }
+
+      private:
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+        void loop(unsigned index, size_t seen)
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            while (true) {
+                wake_.wait(lock, [this, seen] { return stop_ || (generation_ != seen); });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                if (index < active_) {
+                    const std::function<void(unsigned)>& job = *job_;
+                    lock.unlock();
+                    job(index);
+                    lock.lock();
+                    if (--pending_ == 0) {
+                        done_.notify_one();
+                    }
+                }
+            }
+        }
+
+        std::mutex                             run_lock_;
+        std::mutex                             lock_;
+        std::condition_variable                wake_;
+        std::condition_variable                done_;
+        std::vector<std::thread>               threads_;
+        const std::function<void(unsigned)>*   job_;
+        unsigned                               active_;
+        unsigned                               pending_;
+        size_t                                 generation_;
+        bool                                   stop_;
+    };
+
+    static worker_pool& the_worker_pool()
+    {
+        static worker_pool POOL;
+        return POOL;
+    }
+
+    /* the end of the string body starting at p, past its closing quote */
+    static const char* skip_string(const char* p, const char* end)
+    {
+        while (true) {
+            p = scan_string(p, end);
+            if (p == end) {
+                return end;
+            }
+            switch (*p) {
+                case '"':
+                    return p + 1;
+                case '\\':
+                    p = std::min(p + 2, end);
+                    break;
+                default:
+                    ++p;
+                    break;
+            }
+        }
+    }
+
+    /**
+     * Split [begin, end) into about count pieces of similar size, cutting
+     * only at whitespace outside every list, string, comment and character
+     * literal, so that each piece holds whole top level data. The cuts,
+     * begin and end included, are returned in order.
+     */
+    static std::vector<const char*> split_input(const char* begin, const char* end, size_t count)
+    {
+        const size_t step = std::max<size_t>(static_cast<size_t>(end - begin) / count, 1);
+
+        std::vector<const char*> cuts(1, begin);
+        const char* target = begin + step;
+        size_t depth = 0;
+        const char* p = begin;
+        while (p < end) {
+            switch (*p) {
+                case '(':
+                    ++depth;
+                    ++p;
+                    break;
+                case ')':
+                    depth -= (depth != 0);
+                    ++p;
+                    break;
+                case '"':
+                    p = skip_string(p + 1, end);
+                    break;
+                case ';':
+                    p = scan_line(p, end);
+                    break;
+                case '#':
+                    /* #\( and #\" are not structure */
+                    p = ((end - p > 1) && (p[1] == '\\')) ? std::min(p + 3, end) : p + 1;
+                    break;
+                default:
+                    if ((depth == 0) && (p >= target) && char_is(*p, CHAR_SPACE)) {
+                        cuts.push_back(p);
+                        target = p + step;
+                    }
+                    ++p;
+                    break;
+            }
+        }
+        cuts.push_back(end);
+        return cuts;
+    }
+
+    static void read_piece(const char* cur, const char* end, std::vector<object_ptr>& items)
+    {
+        while (true) {
+            const read_result result = try_read_object(cur, end);
+            if (result.status != READ_OBJECT) {
+                ERROR_IF((result.status == READ_ERROR), result.error);
+                break;
+            }
+            items.push_back(result.object);
+        }
+    }
+
+    object_ptr read_objects(const char* begin, const char* end, unsigned threads)
+    {
+        size_t piece_size = MIN_PIECE_SIZE;
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+            piece_size = AUTO_PIECE_SIZE;
+        }
+        const size_t size = static_cast<size_t>(end - begin);
+        threads = static_cast<unsigned>(
+            std::min<size_t>(threads, std::max<size_t>(size / piece_size, 1)));
+
+        std::vector<const char*> cuts;
+        if (threads != 1) {
+            cuts = split_input(begin, end, threads * PIECES_PER_THREAD);
+            /* a few large top level data give fewer pieces than asked for */
+            threads = static_cast<unsigned>(std::min<size_t>(threads, cuts.size() - 1));
+        }
+
+        /* nothing is collected while reading, so the items need no roots */
+        std::vector<object_ptr> items;
+        if (threads == 1) {
+            read_piece(begin, end, items);
+            return object::create_list(items.data(), items.size(), empty_list_value());
+        }
+
+        const size_t pieces = cuts.size() - 1;
+        std::vector<std::vector<object_ptr>> results(pieces);
+        std::vector<std::exception_ptr> errors(pieces);
+        std::vector<gc_arena> arenas(threads);
+        std::atomic<size_t> next(0);
+        {
+            gc_parallel_scope closed;
+            the_worker_pool().run(threads, [&](unsigned t) {
+                gc_arena_scope scope(arenas[t]);
+                for (size_t i = next++; i < pieces; i = next++) {
+                    try {
+                        read_piece(cuts[i], cuts[i + 1], results[i]);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            });
+        }
+
+        for (size_t i = 0; i != pieces; ++i) {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+        }
+        for (size_t t = 0; t != arenas.size(); ++t) {
+            gc_adopt(arenas[t]);
+        }
+        for (size_t i = 0; i != pieces; ++i) {
+            items.insert(items.end(), results[i].begin(), results[i].end());
+        }
+        return object::create_list(items.data(), items.size(), empty_list_value());
+    }
+
+}//namespace uscheme
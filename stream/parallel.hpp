@@ -0,0 +1,55 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file parallel.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_PARALLEL_HPP
+#define USCHEME_STREAM_PARALLEL_HPP
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/except.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    USCHEME_API
+    /**
+     * Read every object in [begin, end), in order, into a list, using up to
+     * threads threads (0 for one per hardware thread, but no more than one
+     * per MiB of input). The input is split at top level datum boundaries
+     * and the pieces are read concurrently; input too small, or with too
+     * few top level data, to be worth splitting is read on this thread.
+     * The first error in input order is rethrown. Call from the thread that
+     * owns the heap.
+     */
+    object_ptr read_objects(const char* begin, const char* end, unsigned threads);
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_PARALLEL_HPP
@@ -0,0 +1,228 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file parser.cpp
+ * \date 2015
+ */
+
+// PKG includes
+#include <uscheme/stream/parser.hpp>
+#include <uscheme/stream/charclass.hpp>
+#include <uscheme/stream/stream.hpp>
+
+namespace uscheme {
+
+    parser::parser()
+      : start_(0)
+      , scan_(0)
+      , end_(0)
+      , depth_(0)
+      , state_(IN_SPACE)
+      , error_(ERR_EOS)
+      , started_(false)
+      , closed_(false)
+    { }
+
+    void parser::feed(const char* data, size_t size)
+    {
+        /* drop what has been read once it is most of the buffer */
+        if (start_ && (start_ >= buffer_.size() / 2)) {
+            buffer_.erase(buffer_.begin(), buffer_.begin() + start_);
+            scan_ -= start_;
+            end_ = (end_ > start_) ? (end_ - start_) : 0;
+            start_ = 0;
+        }
+        buffer_.insert(buffer_.end(), data, data + size);
+    }
+
+    void parser::finish()
+    {
+        closed_ = true;
+    }
+
+    void parser::restart(size_t pos)
+    {
+        start_ = scan_ = pos;
+        depth_ = 0;
+        state_ = IN_SPACE;
+        started_ = false;
+    }
+
+    /* a byte between tokens */
+    void parser::between(size_t pos, char ch)
+    {
+        if (char_is(ch, CHAR_SPACE)) {
+            if (!started_) {
+                start_ = pos + 1;
+            }
+            return;
+        }
+        switch (ch) {
+            case ';': {
+                state_ = IN_COMMENT;
+                return;
+            }
+            case '(': {
+                ++depth_;
+                break;
+            }
+            case ')': {
+                /* a stray one is an object of its own, for the reader to
+                   reject */
+                if (depth_ > 0) {
+                    --depth_;
+                }
+                if (depth_ == 0) {
+                    end_ = pos + 1;
+                    state_ = IN_DONE;
+                }
+                break;
+            }
+            case '"': {
+                state_ = IN_STRING;
+                break;
+            }
+            case '#': {
+                state_ = IN_HASH;
+                break;
+            }
+            default: {
+                state_ = IN_ATOM;
+                break;
+            }
+        }
+        started_ = true;
+    }
+
+    void parser::step(size_t pos, char ch)
+    {
+        switch (state_) {
+            case IN_SPACE: {
+                between(pos, ch);
+                break;
+            }
+            case IN_COMMENT: {
+                if ((ch == '\n') || (ch == '\r')) {
+                    state_ = IN_SPACE;
+                    if (!started_) {
+                        start_ = pos + 1;
+                    }
+                }
+                break;
+            }
+            case IN_HASH: {
+                if (ch == '(') {
+                    ++depth_;
+                    state_ = IN_SPACE;
+                    break;
+                }
+                if (ch == '\\') {
+                    state_ = IN_CHAR;
+                    break;
+                }
+                state_ = IN_ATOM;
+                step(pos, ch);
+                break;
+            }
+            case IN_CHAR: {
+                /* the character itself, even a delimiter */
+                state_ = IN_ATOM;
+                break;
+            }
+            case IN_ATOM: {
+                if (char_is(ch, CHAR_DELIMITER)) {
+                    state_ = IN_SPACE;
+                    if (depth_ == 0) {
+                        end_ = pos;
+                        state_ = IN_DONE;
+                    } else {
+                        between(pos, ch);
+                    }
+                }
+                break;
+            }
+            case IN_STRING: {
+                if (ch == '\\') {
+                    state_ = IN_ESCAPE;
+                } else if (ch == '"') {
+                    state_ = IN_SPACE;
+                    if (depth_ == 0) {
+                        end_ = pos + 1;
+                        state_ = IN_DONE;
+                    }
+                }
+                break;
+            }
+            case IN_ESCAPE: {
+                state_ = IN_STRING;
+                break;
+            }
+            case IN_DONE: {
+                break;
+            }
+        }
+    }
+
+    /* whether [start_, end_) is a whole object, with the byte after it in
+       the buffer, or the end of input, for the reader to check */
+    bool parser::scan()
+    {
+        const char* const data = buffer_.data();
+        const size_t size = buffer_.size();
+        while ((state_ != IN_DONE) && (scan_ != size)) {
+            step(scan_, data[scan_]);
+            ++scan_;
+        }
+        return (state_ == IN_DONE) && ((end_ < size) || closed_);
+    }
+
+    parse_status parser::next(object_ptr& p)
+    {
+        const bool whole = scan();
+        if (!whole) {
+            if (!closed_) {
+                return PARSE_MORE;
+            }
+            if (!started_) {
+                restart(buffer_.size());
+                return PARSE_END;
+            }
+        }
+
+        const char* const begin = buffer_.data() + start_;
+        const char* cur = begin;
+        const read_result result = try_read_object(cur, buffer_.data() + buffer_.size());
+        if (result.status != READ_OBJECT) {
+            restart(whole ? end_ : buffer_.size());
+            error_ = result.error;
+            return PARSE_ERROR;
+        }
+        p = result.object;
+        restart(start_ + static_cast<size_t>(cur - begin));
+        return PARSE_OBJECT;
+    }
+
+}//namespace uscheme
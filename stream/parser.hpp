@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file parser.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_PARSER_HPP
+#define USCHEME_STREAM_PARSER_HPP
+
+// LANG includes
+#include <cstddef>
+#include <vector>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/except.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    /**
+     * What parser::next found.
+     */
+    enum parse_status
+    {
+        PARSE_OBJECT, /* an object was read */
+        PARSE_MORE,   /* the input so far ends inside an object */
+        PARSE_ERROR,  /* an object was malformed; see parser::error */
+        PARSE_END     /* finish was called and all input has been read */
+    };
+
+    /**
+     * Push parser for input that arrives in pieces, e.g. from a socket:
+     *
+     *     uscheme::parser p;
+     *     p.feed(data, size);
+     *     uscheme::object_ptr obj;
+     *     while (p.next(obj) == uscheme::PARSE_OBJECT) {
+     *         ...
+     *     }
+     *
+     * Nothing blocks: fed bytes are kept until they form a whole object,
+     * which a small state machine tracks across calls, and the object is
+     * then read with the in-place reader. Malformed input is reported as
+     * PARSE_ERROR, with the error read_object would throw, and without
+     * throwing; the offending object is dropped, so parsing can go on with
+     * what follows it.
+     */
+    class USCHEME_API parser
+    {
+      public:
+        parser();
+
+        /**
+         * Append size bytes of input.
+         */
+        void feed(const char* data, size_t size);
+
+        /**
+         * Mark the end of input: an object cut short by it is read, and
+         * reported, as it stands.
+         */
+        void finish();
+
+        /**
+         * Read the next object into p if the input holds one.
+         */
+        parse_status next(object_ptr& p);
+
+        /**
+         * Why the last PARSE_ERROR was returned.
+         */
+        except_id error() const
+        {
+            return error_;
+        }
+
+      private:
+        enum scan_state
+        {
+            IN_SPACE,
+            IN_COMMENT,
+            IN_ATOM,
+            IN_HASH,
+            IN_CHAR,
+            IN_STRING,
+            IN_ESCAPE,
+            IN_DONE
+        };
+
+        bool scan();
+        void step(size_t pos, char ch);
+        void between(size_t pos, char ch);
+        void restart(size_t pos);
+
+        std::vector<char> buffer_;
+        size_t            start_;   /* where the next object starts */
+        size_t            scan_;    /* next byte for the state machine */
+        size_t            end_;     /* one past the object, once IN_DONE */
+        size_t            depth_;
+        scan_state        state_;
+        except_id         error_;
+        bool              started_;
+        bool              closed_;
+    };
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_PARSER_HPP
@@ -0,0 +1,256 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file scan.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#  define USCHEME_SCAN_X86 1
+#  include <immintrin.h>
+#else
+#  define USCHEME_SCAN_X86 0
+#endif
+
+// PKG includes
+#include <uscheme/stream/charclass.hpp>
+#include <uscheme/stream/scan.hpp>
+
+namespace uscheme {
+
+    /**
+     * Each scanner exists three times: byte at a time, 16 bytes at a time
+     * with SSE2 and 32 bytes at a time with AVX2. The vector loops only
+     * load whole blocks inside [p, end) and leave the tail to the scalar
+     * loop, so input may end anywhere, including at the end of a mapping.
+     */
+
+    static const char* scan_space_scalar(const char* p, const char* end)
+    {
+        while ((p != end) && char_is(*p, CHAR_SPACE)) {
+            ++p;
+        }
+        return p;
+    }
+
+    static const char* scan_line_scalar(const char* p, const char* end)
+    {
+        while ((p != end) && (*p != '\n') && (*p != '\r')) {
+            ++p;
+        }
+        return p;
+    }
+
+    static const char* scan_string_scalar(const char* p, const char* end)
+    {
+        while ((p != end) && (*p != '"') && (*p != '\\') && (*p != '\0')) {
+            ++p;
+        }
+        return p;
+    }
+
+#if USCHEME_SCAN_X86
+
+    static USCHEME_INLINE
+    __m128i space_mask_sse2(__m128i v)
+    {
+        /* ' ', or v - '\t' <= 4 as unsigned bytes */
+        const __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+        const __m128i in_range = _mm_cmpeq_epi8(
+            _mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+        return _mm_or_si128(in_range, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    }
+
+    static const char* scan_space_sse2(const char* p, const char* end)
+    {
+        for (; end - p >= 16; p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const unsigned other = ~static_cast<unsigned>(
+                _mm_movemask_epi8(space_mask_sse2(v))) & 0xffffu;
+            if (other) {
+                return p + __builtin_ctz(other);
+            }
+        }
+        return scan_space_scalar(p, end);
+    }
+
+    static const char* scan_line_sse2(const char* p, const char* end)
+    {
+        const __m128i nl = _mm_set1_epi8('\n');
+        const __m128i cr = _mm_set1_epi8('\r');
+        for (; end - p >= 16; p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const unsigned hit = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr))));
+            if (hit) {
+                return p + __builtin_ctz(hit);
+            }
+        }
+        return scan_line_scalar(p, end);
+    }
+
+    static const char* scan_string_sse2(const char* p, const char* end)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i slash = _mm_set1_epi8('\\');
+        const __m128i zero = _mm_setzero_si128();
+        for (; end - p >= 16; p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i m = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)),
+                _mm_cmpeq_epi8(v, zero));
+            const unsigned hit = static_cast<unsigned>(_mm_movemask_epi8(m));
+            if (hit) {
+                return p + __builtin_ctz(hit);
+            }
+        }
+        return scan_string_scalar(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    static const char* scan_space_avx2(const char* p, const char* end)
+    {
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i span = _mm256_set1_epi8('\r' - '\t');
+        const __m256i blank = _mm256_set1_epi8(' ');
+        for (; end - p >= 32; p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i shifted = _mm256_sub_epi8(v, tab);
+            const __m256i space = _mm256_or_si256(
+                _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, span), shifted),
+                _mm256_cmpeq_epi8(v, blank));
+            const uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(space));
+            if (other) {
+                return p + __builtin_ctz(other);
+            }
+        }
+        return scan_space_sse2(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    static const char* scan_line_avx2(const char* p, const char* end)
+    {
+        const __m256i nl = _mm256_set1_epi8('\n');
+        const __m256i cr = _mm256_set1_epi8('\r');
+        for (; end - p >= 32; p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, nl), _mm256_cmpeq_epi8(v, cr))));
+            if (hit) {
+                return p + __builtin_ctz(hit);
+            }
+        }
+        return scan_line_sse2(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    static const char* scan_string_avx2(const char* p, const char* end)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i slash = _mm256_set1_epi8('\\');
+        const __m256i zero = _mm256_setzero_si256();
+        for (; end - p >= 32; p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i m = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)),
+                _mm256_cmpeq_epi8(v, zero));
+            const uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+            if (hit) {
+                return p + __builtin_ctz(hit);
+            }
+        }
+        return scan_string_sse2(p, end);
+    }
+
+#endif//USCHEME_SCAN_X86
+
+    typedef const char* (*scan_fn)(const char*, const char*);
+
+    struct scanners
+    {
+        scan_fn space;
+        scan_fn line;
+        scan_fn string;
+    };
+
+    static const scanners SCANNERS[] = {
+        { scan_space_scalar, scan_line_scalar, scan_string_scalar },
+#if USCHEME_SCAN_X86
+        { scan_space_sse2, scan_line_sse2, scan_string_sse2 },
+        { scan_space_avx2, scan_line_avx2, scan_string_avx2 },
+#endif
+    };
+
+    static scan_level widest_scan_level()
+    {
+#if USCHEME_SCAN_X86
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? SCAN_AVX2 : SCAN_SSE2;
+#else
+        return SCAN_SCALAR;
+#endif
+    }
+
+    /* scalar until the initializer below has run */
+    static const scanners* ACTIVE = &SCANNERS[SCAN_SCALAR];
+
+    static scan_level init_scan_level()
+    {
+        const scan_level level = widest_scan_level();
+        ACTIVE = &SCANNERS[level];
+        return level;
+    }
+
+    static const scan_level WIDEST = init_scan_level();
+
+    scan_level set_scan_level(scan_level level)
+    {
+        if (level > WIDEST) {
+            level = WIDEST;
+        }
+        ACTIVE = &SCANNERS[level];
+        return level;
+    }
+
+    const char* scan_space(const char* p, const char* end)
+    {
+        return ACTIVE->space(p, end);
+    }
+
+    const char* scan_line(const char* p, const char* end)
+    {
+        return ACTIVE->line(p, end);
+    }
+
+    const char* scan_string(const char* p, const char* end)
+    {
+        return ACTIVE->string(p, end);
+    }
+
+}//namespace uscheme
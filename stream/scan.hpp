@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file scan.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_SCAN_HPP
+#define USCHEME_STREAM_SCAN_HPP
+
+// PKG includes
+#include <uscheme/defs.hpp>
+
+namespace uscheme {
+
+    /**
+     * Scanner implementations, in increasing order of width.
+     */
+    enum scan_level
+    {
+        SCAN_SCALAR,
+        SCAN_SSE2,
+        SCAN_AVX2
+    };
+
+    USCHEME_API
+    /**
+     * Use the widest scanners up to level that the processor supports, and
+     * return the level in use. The widest supported level is chosen at
+     * startup.
+     */
+    scan_level set_scan_level(scan_level level);
+
+    USCHEME_API
+    /**
+     * The first byte in [p, end) that is not whitespace, or end.
+     */
+    const char* scan_space(const char* p, const char* end);
+
+    USCHEME_API
+    /**
+     * The first '\r' or '\n' in [p, end), or end.
+     */
+    const char* scan_line(const char* p, const char* end);
+
+    USCHEME_API
+    /**
+     * The first '"', '\\' or '\0' in [p, end), or end.
+     */
+    const char* scan_string(const char* p, const char* end);
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_SCAN_HPP
@@ -0,0 +1,218 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file source.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <algorithm>
+#include <cstring>
+
+// PKG includes
+#include <uscheme/stream/source.hpp>
+
+namespace uscheme {
+
+    static void write_varint(std::vector<uint8_t>& out, uint64_t v)
+    {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    static uint64_t read_varint(const std::vector<uint8_t>& in, size_t& pos)
+    {
+        uint64_t v = 0;
+        for (unsigned shift = 0; ; shift += 7) {
+            const uint8_t b = in[pos++];
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) {
+                return v;
+            }
+        }
+    }
+
+    /* small deltas of either sign as small unsigned numbers */
+    static uint64_t zigzag(int64_t v)
+    {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t v)
+    {
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    /* every collection moves or frees cells, so addresses go stale */
+    static size_t collection_epoch()
+    {
+        const gc_stats stats = gc_statistics();
+        return stats.collections + stats.minor_collections;
+    }
+
+    source_map::source_map(const char* name)
+      : name_(name)
+      , offset_(0)
+      , line_starts_(1, 0)
+      , lines_before_(0)
+      , spans_()
+      , checkpoints_()
+      , last_start_(0)
+      , count_(0)
+      , keys_(empty_list_value())
+      , keys_root_(keys_)
+      , index_()
+      , indexed_(0)
+      , indexed_epoch_(0)
+    { }
+
+    void source_map::advance(const char* p, const char* q)
+    {
+        const char* const begin = p;
+        while (p != q) {
+            p = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(q - p)));
+            if (!p) {
+                break;
+            }
+            ++p;
+            line_starts_.push_back(offset_ + static_cast<size_t>(p - begin));
+        }
+        offset_ += static_cast<size_t>(q - begin);
+    }
+
+    void source_map::record(const object_ptr& p, size_t begin, size_t end)
+    {
+        if ((count_ % CHECKPOINT_INTERVAL) == 0) {
+            const checkpoint cp = { spans_.size(), last_start_ };
+            checkpoints_.push_back(cp);
+        }
+        write_varint(spans_, zigzag(static_cast<int64_t>(begin - last_start_)));
+        write_varint(spans_, end - begin);
+        last_start_ = begin;
+
+        const size_t capacity = keys_.is_vector() ? keys_->vector_length() : 0;
+        if (count_ == capacity) {
+            object_ptr bigger = object::create_vector(std::max<size_t>(2 * capacity, 64),
+                                                      empty_list_value());
+            for (size_t i = 0; i != count_; ++i) {
+                bigger->vector_set(i, keys_->vector_ref(i));
+            }
+            keys_ = bigger;
+        }
+        keys_->vector_set(count_, p);
+        ++count_;
+    }
+
+    void source_map::truncate(size_t n)
+    {
+        if (n >= count_) {
+            return;
+        }
+        size_t byte, start, end;
+        decode(n, byte, start, end);
+        last_start_ = checkpoints_[n / CHECKPOINT_INTERVAL].start;
+        if ((n % CHECKPOINT_INTERVAL) != 0) {
+            size_t previous;
+            decode(n - 1, previous, last_start_, end);
+        }
+        spans_.resize(byte);
+        checkpoints_.resize((n + CHECKPOINT_INTERVAL - 1) / CHECKPOINT_INTERVAL);
+        for (size_t i = n; i != count_; ++i) {
+            keys_->vector_set(i, empty_list_value());
+        }
+        count_ = n;
+        index_.clear();
+        indexed_ = 0;
+    }
+
+    void source_map::clear()
+    {
+        spans_.clear();
+        checkpoints_.clear();
+        count_ = 0;
+        keys_ = empty_list_value();
+        index_.clear();
+        indexed_ = 0;
+
+        /* later data start on the current line or after it */
+        lines_before_ += line_starts_.size() - 1;
+        line_starts_.erase(line_starts_.begin(), line_starts_.end() - 1);
+    }
+
+    /* entry n: where its encoding starts in spans_, and its offsets */
+    void source_map::decode(size_t n, size_t& byte, size_t& start, size_t& end) const
+    {
+        const checkpoint& cp = checkpoints_[n / CHECKPOINT_INTERVAL];
+        byte = cp.byte;
+        start = cp.start;
+        for (size_t i = n - (n % CHECKPOINT_INTERVAL); ; ++i) {
+            const size_t at = byte;
+            start += static_cast<size_t>(unzigzag(read_varint(spans_, byte)));
+            end = start + static_cast<size_t>(read_varint(spans_, byte));
+            if (i == n) {
+                byte = at;
+                return;
+            }
+        }
+    }
+
+    void source_map::position(size_t offset, size_t& line, size_t& column) const
+    {
+        const auto next = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset);
+        line = lines_before_ + static_cast<size_t>(next - line_starts_.begin());
+        column = offset - next[-1] + 1;
+    }
+
+    bool source_map::find(const object_ptr& p, source_span& span) const
+    {
+        if (!p.is_heap()) {
+            return false;
+        }
+        const size_t epoch = collection_epoch();
+        if (epoch != indexed_epoch_) {
+            index_.clear();
+            indexed_ = 0;
+            indexed_epoch_ = epoch;
+        }
+        for (; indexed_ != count_; ++indexed_) {
+            index_.insert(std::make_pair(keys_->vector_ref(indexed_).get(), indexed_));
+        }
+
+        const auto it = index_.find(p.get());
+        if (it == index_.end()) {
+            return false;
+        }
+        size_t byte, start, end;
+        decode(it->second, byte, start, end);
+        position(start, span.line, span.column);
+        position(end, span.end_line, span.end_column);
+        return true;
+    }
+
+}//namespace uscheme
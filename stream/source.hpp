@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file source.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_STREAM_SOURCE_HPP
+#define USCHEME_STREAM_SOURCE_HPP
+
+// LANG includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/gc/heap.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    /**
+     * Where a datum was read: the line and column, both counted from 1, of
+     * its first character and of the character just past it. Columns
+     * count bytes.
+     */
+    struct source_span
+    {
+        size_t line;
+        size_t column;
+        size_t end_line;
+        size_t end_column;
+    };
+
+    /**
+     * Side table of where the data read from one input came from. Objects
+     * carry no position themselves: a reader given a source_map through
+     * reader_options::sources records here every datum it makes that is a
+     * heap cell (lists, vectors, strings, flonums and bignums), and
+     * nothing is paid when no map is given.
+     *
+     *     uscheme::source_map sources("init.scm");
+     *     uscheme::reader_options options;
+     *     options.sources = &sources;
+     *     uscheme::reader r(options);
+     *     uscheme::object_ptr p = r.read(cur, end);
+     *     uscheme::source_span span;
+     *     if (sources.find(p, span)) { ... span.line ... }
+     *
+     * Spans are kept as delta encoded byte offsets, a few bytes a datum,
+     * plus the offset of every line start. The recorded objects are kept
+     * alive by the map until clear() or its destruction, so a map that
+     * lives as long as a REPL or a long load should be cleared once the
+     * data read so far are done with. All input must reach the map through
+     * its readers, in order, for the positions to be right.
+     */
+    class USCHEME_API source_map
+    {
+      public:
+        explicit source_map(const char* name);
+
+        const char* name() const { return name_.c_str(); }
+
+        /**
+         * The number of data recorded.
+         */
+        size_t size() const { return count_; }
+
+        /**
+         * Find where p was read.
+         */
+        bool find(const object_ptr& p, source_span& span) const;
+
+        /*
+         * The reader's side.
+         */
+
+        /**
+         * The number of input bytes seen so far.
+         */
+        size_t offset() const { return offset_; }
+
+        /**
+         * Note the input bytes [p, q), which follow those already seen.
+         */
+        void advance(const char* p, const char* q);
+
+        /**
+         * Record that p was read from the bytes at offsets [begin, end).
+         */
+        void record(const object_ptr& p, size_t begin, size_t end);
+
+        /**
+         * Forget every datum recorded after the first n.
+         */
+        void truncate(size_t n);
+
+        /**
+         * Forget every datum recorded so far and release them to the
+         * collector. Positions of data read later still count from the
+         * start of input.
+         */
+        void clear();
+
+      private:
+        source_map(const source_map&) = delete;
+        source_map& operator=(const source_map&) = delete;
+
+        /* decoding restarts every CHECKPOINT_INTERVAL entries */
+        static const size_t CHECKPOINT_INTERVAL = 64;
+
+        struct checkpoint
+        {
+            size_t byte;  /* where the entry starts in spans_ */
+            size_t start; /* the start offset of the entry before it */
+        };
+
+        void decode(size_t n, size_t& byte, size_t& start, size_t& end) const;
+        void position(size_t offset, size_t& line, size_t& column) const;
+
+        std::string             name_;
+        size_t                  offset_;
+        std::vector<size_t>     line_starts_; /* from line lines_before_ + 1 on */
+        size_t                  lines_before_;
+        std::vector<uint8_t>    spans_;
+        std::vector<checkpoint> checkpoints_;
+        size_t                  last_start_;
+        size_t                  count_;
+        object_ptr              keys_;      /* vector of the recorded objects */
+        gc_root                 keys_root_;
+
+        /* where each key is, by address; rebuilt after a collection */
+        mutable std::unordered_map<const object*, size_t> index_;
+        mutable size_t                                    indexed_;
+        mutable size_t                                    indexed_epoch_;
+    };
+
+}//namespace uscheme
+
+#endif//USCHEME_STREAM_SOURCE_HPP
@@ -29,32 +29,225 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
 // LANG includes
+#include <climits>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // PKG includes
 #include <uscheme/except.hpp>
 #include <uscheme/stream/stream.hpp>
+#include <uscheme/type/number.hpp>
+#include <uscheme/stream/decimal.hpp>
+#include <uscheme/stream/charclass.hpp>
+#include <uscheme/stream/scan.hpp>
+#include <uscheme/stream/source.hpp>
+#include <uscheme/stream/literal.hpp>
 
 #define ERROR_IF(cond, id)        \
  if ((cond)) {                    \
     throw uscheme::exception(id); \
  }
 
+/* inside the reader errors are returned, not thrown; see fail() */
+#define FAIL_IF(cond, id)         \
+ if ((cond)) {                    \
+    return fail(r, (id));         \
+ }
+
 namespace uscheme {
 
+    static USCHEME_INLINE
     bool is_delimiter(char ch)
     {
-        return isspace(ch) || (ch == EOF) ||
-            (ch == '(') || (ch == ')') ||
-            (ch == '"') || (ch == ';');
+        return char_is(ch, CHAR_DELIMITER);
+    }
+
+    static USCHEME_INLINE
+    bool is_space(char ch)
+    {
+        return char_is(ch, CHAR_SPACE);
+    }
+
+    static USCHEME_INLINE
+    bool is_digit(char ch)
+    {
+        return char_is(ch, CHAR_DIGIT);
+    }
+
+    static USCHEME_INLINE
+    bool is_subsequent(char ch)
+    {
+        return char_is(ch, CHAR_SUBSEQUENT);
+    }
+
+    /* ASCII only, like the character classes */
+    static USCHEME_INLINE
+    char to_lower(char ch)
+    {
+        return ((ch >= 'A') && (ch <= 'Z')) ? static_cast<char>(ch - 'A' + 'a') : ch;
+    }
+
+    /**
+     * The reader works on a window [cur, end) of contiguous input. A span
+     * is read in place; a stream refills the window from its streambuf in
+     * large chunks, moving the bytes from a kept position on to the front
+     * first, so that a token being read always stays contiguous. Scratch
+     * space and options are the reader's.
+     */
+    struct input
+    {
+        const char*        cur;
+        const char*        end;
+        std::streambuf*    sb;
+        std::vector<char>* buffer;
+        bool               at_eof;
+        bool               failed;
+        except_id          error;   /* why, once failed */
+        source_map*        sources; /* null unless positions are recorded */
+        const char*        origin;  /* the byte at sources->offset() */
+
+        const reader_options&      options;
+        std::string&               scratch; /* strings with escapes are built here */
+        std::vector<reader_frame>& frames;
+        std::vector<object_ptr>&   values;
+
+        static const size_t CHUNK_SIZE = 64 * 1024;
+
+        /* make more input available at end, keeping [keep, end) and
+           adjusting keep and cur; false once the input is exhausted */
+        bool refill(const char*& keep)
+        {
+            if (!sb || at_eof) {
+                return false;
+            }
+
+            const size_t kept = static_cast<size_t>(end - keep);
+            const size_t offset = static_cast<size_t>(cur - keep);
+
+            /* only take what the streambuf already holds, so that whatever
+               is not read can be put back into it afterwards */
+            std::streamsize avail = sb->in_avail();
+            if (avail <= 0) {
+                if (sb->sgetc() == EOF) {
+                    at_eof = true;
+                    return false;
+                }
+                avail = std::max<std::streamsize>(sb->in_avail(), 1);
+            }
+            const size_t want = std::min<size_t>(static_cast<size_t>(avail), size_t(CHUNK_SIZE));
+
+            std::vector<char>& buf = *buffer;
+            if (sources) {
+                /* the bytes before keep are about to go */
+                sources->advance(origin, keep);
+            }
+            if (kept && (keep != buf.data())) {
+                memmove(buf.data(), keep, kept);
+            }
+            if (buf.size() < kept + want) {
+                buf.resize(kept + want);
+            }
+            const size_t got = static_cast<size_t>(sb->sgetn(buf.data() + kept, want));
+
+            keep = buf.data();
+            cur = keep + offset;
+            end = keep + kept + got;
+            origin = keep;
+            return got != 0;
+        }
+
+        bool refill()
+        {
+            const char* keep = cur;
+            return refill(keep);
+        }
+
+        /* at least n bytes at cur, unless the input ends first */
+        USCHEME_INLINE
+        bool available(size_t n)
+        {
+            while (static_cast<size_t>(end - cur) < n) {
+                if (!refill()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        USCHEME_INLINE
+        char peek(size_t i = 0)
+        {
+            return available(i + 1) ? cur[i] : static_cast<char>(EOF);
+        }
+
+        USCHEME_INLINE
+        char get()
+        {
+            const char ch = peek();
+            if (cur != end) {
+                ++cur;
+            }
+            return ch;
+        }
+    };
+
+    /* the source offset of p in the window */
+    static USCHEME_INLINE
+    size_t source_offset(const input& r, const char* p)
+    {
+        return r.sources->offset() + static_cast<size_t>(p - r.origin);
+    }
+
+    /* literals come from the table when there is one */
+    static USCHEME_INLINE
+    object_ptr make_string(const input& r, const char* value, size_t length)
+    {
+        literal_table* const literals = r.options.literals;
+        return literals ? literals->string(value, length) : object::create_string(value, length);
+    }
+
+    static USCHEME_INLINE
+    object_ptr make_flonum(const input& r, double value)
+    {
+        literal_table* const literals = r.options.literals;
+        return literals ? literals->flonum(value) : object::create_flonum(value);
+    }
+
+    /* record why reading stopped; the caller returns at once */
+    static object_ptr fail(input& r, except_id id)
+    {
+        r.failed = true;
+        r.error = id;
+        return object_ptr();
     }
 
-    bool is_whitespace(char ch)
+    void skip_line(input& r)
     {
-        return isspace(ch) || (ch == ';') || (ch == EOF);
+        while (true) {
+            const char* p = scan_line(r.cur, r.end);
+            r.cur = p;
+            if ((p != r.end) || !r.refill()) {
+                break;
+            }
+        }
+        switch (r.peek()) {
+            case '\r':
+                r.get();
+                if (r.peek() == '\n') { r.get(); }
+                break;
+            case '\n':
+                r.get();
+                break;
+            default:
+                break;
+        }
+        return;
     }
 
     void skip_line(std::istream& s)
@@ -78,33 +271,73 @@ namespace uscheme {
         return;
     }
 
-    void skip_whitespace(std::istream& s)
+    void skip_whitespace(input& r)
     {
-        char ch;
         while (true) {
-            ch = s.peek();
-            if (isspace(ch)) {
-                s.get();
-                continue;
+            const char* p = r.cur;
+            /* most runs are a single separator, which is not worth a call */
+            if ((p != r.end) && is_space(*p)) {
+                ++p;
+                if ((p != r.end) && is_space(*p)) {
+                    p = scan_space(p, r.end);
+                }
+            }
+            r.cur = p;
+            if (p == r.end) {
+                if (r.refill()) {
+                    continue;
+                }
+                break;
             }
-            if (ch == ';') {
+            if (*p == ';') {
                 // comments are whitespace too
-                s.get();
-                skip_line(s);
+                ++r.cur;
+                skip_line(r);
                 continue;
             }
             break;
         }
     }
 
-    object_type determine_type(std::istream& s)
+    /* the radix a #x, #o, #b or #d prefix gives, or 0 */
+    static USCHEME_INLINE
+    unsigned radix_of(char ch)
     {
+        switch (ch | 0x20) {
+            case 'x': return 16;
+            case 'o': return 8;
+            case 'b': return 2;
+            case 'd': return 10;
+            default : return 0;
+        }
+    }
+
+    object_type determine_type(input& r)
+    {
+        const char ch = r.peek();
+
+        /* identifiers and numbers by class, the rest by the character */
+        const unsigned cls = CHAR_CLASS[static_cast<unsigned char>(ch)];
+        if (cls & CHAR_INITIAL) {
+            return SYMBOL;
+        }
+        if (cls & CHAR_DIGIT) {
+            return FIXNUM;
+        }
+        if (cls & CHAR_SIGN) {
+            /* a sign starts a number only if a digit or point follows */
+            const char next = r.peek(1);
+            return (is_digit(next) || (next == '.')) ? FIXNUM : SYMBOL;
+        }
+
         object_type t;
-        switch (s.peek()) {
+        switch (ch) {
             case '#': {
-                s.get();
-                t = (s.peek() == '\\') ? CHARACTER : BOOLEAN;
-                s.unget();
+                switch (r.peek(1)) {
+                    case '\\': t = CHARACTER; break;
+                    case '(' : t = VECTOR; break;
+                    default  : t = radix_of(r.peek(1)) ? FIXNUM : BOOLEAN; break;
+                }
                 break;
             }
             case '"': {
@@ -112,60 +345,99 @@ namespace uscheme {
                 break;
             }
             case '(': {
-                t = EMPTY_LIST;
+                t = PAIR;
                 break;
             }
-            /* number */
-            case '+': /* fall through */
-            case '-': /* fall through */
-            case '0': /* fall through */
-            case '1': /* fall through */
-            case '2': /* fall through */
-            case '3': /* fall through */
-            case '4': /* fall through */
-            case '5': /* fall through */
-            case '6': /* fall through */
-            case '7': /* fall through */
-            case '8': /* fall through */
-            case '9': {
-                t = FIXNUM;
+            case '.': {
+                if (is_digit(r.peek(1))) {
+                    t = FLONUM;
+                } else if (is_delimiter(r.peek(1))) {
+                    /* a lone dot only marks the tail of a list, which the
+                       caller has taken already */
+                    const bool in_vector = !r.frames.empty() &&
+                                           (r.frames.back().state == reader_frame::IN_VECTOR);
+                    fail(r, in_vector ? ERR_TERM_VEC : r.frames.empty() ? ERR_INV_SYM : ERR_TERM_LIST);
+                    t = SYMBOL;
+                } else {
+                    t = SYMBOL;
+                }
                 break;
             }
             default: {
-                ERROR_IF(true, ERR_UNK_TYPE);
+                /* the caller checks r.failed before looking at t */
+                fail(r, ERR_UNK_TYPE);
+                t = SYMBOL;
                 break;
             }
         }
         return t;
     }
 
-    object_ptr read_fixnum(std::istream& s)
+    /* the token at cur, up to the next delimiter */
+    void scan_token(input& r, const char*& start)
     {
-        char ch = s.peek();
-        
-        long sign = (ch == '-') ? -1 : 1;
-        long num = 0;
-        
-        if (ch == '-' || ch == '+') { s.get(); }
-
-        ch = s.peek();
-        while (isdigit(ch)) {
-            num = (num * 10) + (ch - '0');
-            s.get();
-            ch = s.peek();
+        start = r.cur;
+        while (true) {
+            const char* p = r.cur;
+            while ((p != r.end) && !is_delimiter(*p)) {
+                ++p;
+            }
+            r.cur = p;
+            if ((p != r.end) || !r.refill(start)) {
+                break;
+            }
         }
+    }
+
+    object_ptr read_number(input& r)
+    {
+        const char* start;
+        scan_token(r, start);
+        const char* const end = r.cur;
 
-        num *= sign;
+        const char* p = start;
+        unsigned radix = 10;
+        if (*p == '#') {
+            radix = radix_of(p[1]);
+            p += 2;
+            FAIL_IF(p == end, ERR_TERM_NUM);
+        }
+        const char* const text = p;
+        const bool negative = (*p == '-');
+        if ((*p == '-') || (*p == '+')) { ++p; }
+        const char* const digits = p;
 
-        ERROR_IF(!is_delimiter(ch), ERR_TERM_NUM);
+        uint64_t mag = 0;
+        p = parse_digits(digits, end, radix, &mag);
+        if ((p == end) && (p != digits)) {
+            const uint64_t max = static_cast<uint64_t>(LONG_MAX);
+            if (mag <= max + negative) {
+                return make_integer(negative ? static_cast<long>(0 - mag) : static_cast<long>(mag));
+            }
+        }
 
-        return object::create_fixnum(num);
+        /* an integer too large for a long, or a flonum */
+        while ((p != end) && (digit_value(*p) < radix)) {
+            ++p;
+        }
+        if ((p == end) && (p != digits)) {
+            const object_ptr p = integer_from_digits(digits, static_cast<size_t>(end - digits),
+                                                     radix, negative);
+            literal_table* const literals = r.options.literals;
+            return literals ? literals->share(p) : p;
+        }
+        double value;
+        FAIL_IF((radix != 10) || !parse_double(text, end, &value), ERR_TERM_NUM);
+        return make_flonum(r, value);
     }
 
-    object_ptr read_boolean(std::istream& s)
+    object_ptr read_boolean(input& r)
     {
-        char ch = s.get();
-        ch = s.get();
+        char ch = r.get();
+        ch = r.get();
+        if (r.options.fold_case) {
+            ch = to_lower(ch);
+        }
 
         bool value = false;
 
@@ -173,97 +445,77 @@ namespace uscheme {
             case 't': value = true; break;
             case 'f': break;
             default :
-                ERROR_IF(true, ERR_INV_BOOL);
+                return fail(r, ERR_INV_BOOL);
         }
 
         return value ? true_value() : false_value();
     }
 
-    object_ptr read_character(std::istream& s)
+    object_ptr read_character(input& r)
     {
-        char ch = s.get(); /* get # */
-        ch = s.get();      /* get \ */
-        ch = s.get();
+        r.get();           /* get # */
+        r.get();           /* get \ */
+        char ch = r.get();
 
-        object_ptr p;
+        /* could be newline or tab or space or just n or t or s */
+        const bool fold = r.options.fold_case;
+        const char* rest;
+        char named;
+        except_id err;
+        switch (fold ? to_lower(ch) : ch) {
+            case 'n': rest = "ewline"; named = '\n'; err = ERR_CHAR_NL; break;
+            case 't': rest = "ab";     named = '\t'; err = ERR_CHAR_TB; break;
+            case 's': rest = "pace";   named = ' ';  err = ERR_CHAR_SP; break;
+            default : return object::create_character(ch);
+        }
 
-        if (ch != 'n' && ch != 't' && ch != 's') {
-            p = object::create_character(ch);
-        } else {
-            /* could be newline or tab or space or just n or t or s */
-            char characters[8];
-            size_t numpushed = 0;
-            if (ch == 'n') {
-                if (is_delimiter(s.peek())) {
-                    p = object::create_character('n');
-                } else {
-                    /* better match ewline */
-                    for (; numpushed != 6; ++numpushed) {
-                        characters[numpushed] = s.get();
-                    }
-                    characters[numpushed] = '\0';
-                    if (strcmp(characters, "ewline") == 0) {
-                        p = object::create_character('\n');
-                    } else {
-                        for (size_t nchar = 0; nchar != numpushed; ++nchar) {
-                            s.unget();
-                        }
-                        ERROR_IF(true, ERR_CHAR_NL);
-                    }
-                }
-            }
-            if (ch == 't') {
-                if (is_delimiter(s.peek())) {
-                    p = object::create_character('t');
-                } else {
-                    /* better match ab */
-                    for (; numpushed != 2; ++numpushed) {
-                        characters[numpushed] = s.get();
-                    }
-                    characters[numpushed] = '\0';
-                    if (strcmp(characters, "ab") == 0) {
-                        p = object::create_character('\t');
-                    } else {
-                        for (size_t nchar = 0; nchar != numpushed; ++nchar) {
-                            s.unget();
-                        }
-                        ERROR_IF(true, ERR_CHAR_TB);
-                    }
-                }
-            }
-            if (ch == 's') {
-                if (is_delimiter(s.peek())) {
-                    p = object::create_character('s');
-                } else {
-                    /* better match pace */
-                    for (; numpushed != 4; ++numpushed) {
-                        characters[numpushed] = s.get();
-                    }
-                    characters[numpushed] = '\0';
-                    if (strcmp(characters, "pace") == 0) {
-                        p = object::create_character(' ');
-                    } else {
-                        for (size_t nchar = 0; nchar != numpushed; ++nchar) {
-                            s.unget();
-                        }
-                        ERROR_IF(true, ERR_CHAR_SP);
-                    }
-                }
-            }
+        if (is_delimiter(r.peek())) {
+            return object::create_character(ch);
+        }
+        const size_t length = strlen(rest);
+        FAIL_IF(!r.available(length), err);
+        for (size_t i = 0; i != length; ++i) {
+            FAIL_IF(((fold ? to_lower(r.cur[i]) : r.cur[i]) != rest[i]), err);
         }
-        return p;
+        r.cur += length;
+        return object::create_character(named);
     }
 
-    object_ptr read_string(std::istream& s)
+    object_ptr read_string(input& r)
     {
-        static std::string BUFFER;
-        BUFFER.resize(0);
+        r.get(); /* skip the " */
 
-        char ch = s.get(); /* skip the " */
-        while ((ch = s.peek()) != EOF && (ch != '\0') && (ch != '"')) {
-            if (ch == '\\') {
-                s.get();
-                switch (s.peek()) {
+        /* without escapes the characters are used in place */
+        const char* start = r.cur;
+        while (true) {
+            r.cur = scan_string(r.cur, r.end);
+            if ((r.cur != r.end) || !r.refill(start)) {
+                break;
+            }
+        }
+
+        object_ptr str;
+        if ((r.cur != r.end) && (*r.cur == '"')) {
+            str = make_string(r, start, static_cast<size_t>(r.cur - start));
+        } else {
+            r.scratch.assign(start, r.cur);
+            while (true) {
+                /* runs between escapes are copied in bulk */
+                const char* p = scan_string(r.cur, r.end);
+                r.scratch.append(r.cur, p);
+                r.cur = p;
+                if (p == r.end) {
+                    if (r.refill()) {
+                        continue;
+                    }
+                    break;
+                }
+                if (*p != '\\') {
+                    break;
+                }
+                r.get();
+                char ch = r.peek();
+                switch (ch) {
                     case '\\': {
                         ch = '\\';
                         break;
@@ -293,65 +545,347 @@ namespace uscheme {
                         break;
                     }
                     default: {
+                        /* kept as is by the next run */
                         continue;
-                        // s.unget();
-                        break;
                     }
                 }
+                r.scratch.push_back(ch);
+                r.get();
+            }
+            FAIL_IF((r.cur == r.end) || (*r.cur != '"'), ERR_STR_ABR);
+            str = make_string(r, r.scratch.data(), r.scratch.size());
+        }
+
+        r.get();
+        FAIL_IF(!is_delimiter(r.peek()), ERR_TERM_STR);
+
+        return str;
+    }
+
+    object_ptr read_symbol(input& r)
+    {
+        const char* start;
+        scan_token(r, start);
+        const size_t length = static_cast<size_t>(r.cur - start);
+        for (size_t i = 0; i != length; ++i) {
+            FAIL_IF(!is_subsequent(start[i]), ERR_INV_SYM);
+        }
+        if (r.options.fold_case &&
+            std::any_of(start, start + length, [](char c) { return to_lower(c) != c; })) {
+            r.scratch.resize(length);
+            std::transform(start, start + length, r.scratch.begin(),
+                           [](char c) { return to_lower(c); });
+            start = r.scratch.data();
+        }
+
+        /* the infinities and NaNs are spelled like identifiers */
+        if ((length == 6) && ((start[0] == '+') || (start[0] == '-'))) {
+            const double sign = (start[0] == '-') ? -1.0 : 1.0;
+            if (memcmp(start + 1, "inf.0", 5) == 0) {
+                return make_flonum(r, sign * HUGE_VAL);
+            }
+            if (memcmp(start + 1, "nan.0", 5) == 0) {
+                return make_flonum(r, NAN);
             }
-            BUFFER.push_back(ch);
-            s.get();
         }
-        
-        ERROR_IF((ch != '"'), ERR_STR_ABR);
-        s.get();
-        ERROR_IF(!is_whitespace(s.peek()), ERR_TERM_STR);
 
-        return object::create_string(BUFFER.c_str());
+        return object::create_symbol(start, length);
     }
 
-    object_ptr read_empty_list(std::istream& s)
+    /* the values from base up, as a vector */
+    object_ptr close_vector(input& r, size_t base)
     {
-        s.get(); /* skip '(' */
-        skip_whitespace(s);
-        ERROR_IF((s.peek() != ')'), ERR_TERM_EMPTY);
-        s.get();
-        ERROR_IF(!is_whitespace(s.peek()), ERR_TERM_EMPTY);
-        return empty_list_value();
+        r.get(); /* skip ')' */
+        FAIL_IF(!is_delimiter(r.peek()), ERR_TERM_VEC);
+
+        const size_t length = r.values.size() - base;
+        object_ptr v = object::create_vector(length, empty_list_value());
+        std::copy(r.values.begin() + base, r.values.end(), v->vector_data());
+        r.values.resize(base);
+        return v;
     }
 
-    object_ptr read_object(std::istream& s)
+    /* the same, as a list ending in tail */
+    object_ptr close_list(input& r, size_t base, const object_ptr& tail)
     {
-        skip_whitespace(s);
-        ERROR_IF(s.eof(), ERR_EOS);
+        const size_t length = r.values.size() - base;
+        r.get(); /* skip ')' */
+        FAIL_IF(!is_delimiter(r.peek()), (length == 0) ? ERR_TERM_EMPTY : ERR_TERM_LIST);
+
+        /* elements are read first so that the pairs can be allocated as one
+           sequential run; nothing is collected while reading */
+        object_ptr l = object::create_list(r.values.data() + base, length, tail);
+        r.values.resize(base);
+        return l;
+    }
+
+    /**
+     * Lists and vectors are read without recursion: each open one has a
+     * frame on r.frames, and its elements so far sit on r.values above the
+     * frame's base until its closing paren is seen. Nesting depth is only
+     * bounded by memory.
+     */
+    object_ptr read_object(input& r)
+    {
+        r.frames.clear();
+        r.values.clear();
 
-        const auto t = determine_type(s);
         object_ptr p;
-        switch (t) {
-            case FIXNUM:
-                p = read_fixnum(s);
-                break;
-            case BOOLEAN:
-                p = read_boolean(s);
-                break;
-            case CHARACTER:
-                p = read_character(s);
-                break;
-            case STRING:
-                p = read_string(s);
-                break;
-            case EMPTY_LIST:
-                p = read_empty_list(s);
-                break;    
+        while (true) {
+            skip_whitespace(r);
+            bool closed = false;
+            size_t start = 0;
+            if (!r.frames.empty() && (r.frames.back().state != reader_frame::DOTTED_TAIL)) {
+                reader_frame& f = r.frames.back();
+                const size_t length = r.values.size() - f.base;
+                const char ch = r.peek();
+                if (f.state == reader_frame::IN_VECTOR) {
+                    FAIL_IF(!r.available(1), ERR_TERM_VEC);
+                    if (ch == ')') {
+                        p = close_vector(r, f.base);
+                        start = f.start;
+                        r.frames.pop_back();
+                        closed = true;
+                    }
+                } else {
+                    FAIL_IF(!r.available(1), (length == 0) ? ERR_TERM_EMPTY : ERR_TERM_LIST);
+                    if (ch == ')') {
+                        p = close_list(r, f.base, empty_list_value());
+                        start = f.start;
+                        r.frames.pop_back();
+                        closed = true;
+                    } else if ((ch == '.') && (length != 0) && is_delimiter(r.peek(1))) {
+                        r.get();
+                        f.state = reader_frame::DOTTED_TAIL;
+                        continue;
+                    }
+                }
+            } else {
+                /* input that ends after the dot of a list is cut short */
+                FAIL_IF(!r.available(1), r.frames.empty() ? ERR_EOS : ERR_TERM_LIST);
+            }
+
+            if (!closed) {
+                if (r.sources) {
+                    start = source_offset(r, r.cur);
+                }
+                const object_type t = determine_type(r);
+                if (r.failed) {
+                    return object_ptr();
+                }
+                switch (t) {
+                    case FIXNUM: /* fall through */
+                    case BIGNUM: /* fall through */
+                    case FLONUM:
+                        p = read_number(r);
+                        break;
+                    case BOOLEAN:
+                        p = read_boolean(r);
+                        break;
+                    case CHARACTER:
+                        p = read_character(r);
+                        break;
+                    case STRING:
+                        p = read_string(r);
+                        break;
+                    case EMPTY_LIST: /* fall through */
+                    case PAIR: {
+                        r.get(); /* skip '(' */
+                        const reader_frame f = { reader_frame::IN_LIST, r.values.size(), start };
+                        r.frames.push_back(f);
+                        continue;
+                    }
+                    case SYMBOL:
+                        p = read_symbol(r);
+                        break;
+                    case VECTOR: {
+                        r.get(); /* skip '#' */
+                        r.get(); /* skip '(' */
+                        const reader_frame f = { reader_frame::IN_VECTOR, r.values.size(), start };
+                        r.frames.push_back(f);
+                        continue;
+                    }
+                }
+            }
+            if (r.failed) {
+                return object_ptr();
+            }
+            if (r.sources && p.is_heap()) {
+                r.sources->record(p, start, source_offset(r, r.cur));
+            }
+
+            /* hand p to the innermost open list or vector, closing a list
+               whose dotted tail it is */
+            while (true) {
+                if (r.frames.empty()) {
+                    return p;
+                }
+                reader_frame& f = r.frames.back();
+                if (f.state != reader_frame::DOTTED_TAIL) {
+                    r.values.push_back(p);
+                    break;
+                }
+                skip_whitespace(r);
+                FAIL_IF((r.peek() != ')'), ERR_TERM_LIST);
+                p = close_list(r, f.base, p);
+                if (r.failed) {
+                    return object_ptr();
+                }
+                if (r.sources) {
+                    r.sources->record(p, f.start, source_offset(r, r.cur));
+                }
+                r.frames.pop_back();
+            }
         }
-        return p;
     }
 
-    void print_object(std::ostream& os, const object_ptr& p)
+    /* hands what was taken from the streambuf but not read back to it */
+    struct stream_input : input
+    {
+        std::istream& s;
+
+        stream_input(std::istream& s_, const input& base)
+          : input(base)
+          , s(s_)
+        { }
+
+        ~stream_input()
+        {
+            while ((end != cur) && (sb->sputbackc(end[-1]) != EOF)) {
+                --end;
+            }
+            if (at_eof) {
+                s.setstate(std::ios::eofbit);
+            }
+        }
+    };
+
+    reader::reader()
+      : options_()
+      , scratch_()
+      , buffer_()
+      , frames_()
+      , values_()
+    { }
+
+    reader::reader(const reader_options& options)
+      : options_(options)
+      , scratch_()
+      , buffer_()
+      , frames_()
+      , values_()
+    { }
+
+    /* the result of a read that stopped at r */
+    static read_result finish_read(const input& r, const object_ptr& p)
+    {
+        read_result result;
+        result.status = !r.failed ? READ_OBJECT : (r.error == ERR_EOS) ? READ_EOS : READ_ERROR;
+        result.error = r.error;
+        result.object = p;
+        return result;
+    }
+
+    read_result reader::try_read(const char*& begin, const char* end)
+    {
+        source_map* const sources = options_.sources;
+        const size_t recorded = sources ? sources->size() : 0;
+
+        input r = { begin, end, nullptr, nullptr, false, false, ERR_EOS, sources, begin,
+                    options_, scratch_, frames_, values_ };
+        const object_ptr p = read_object(r);
+        if (!r.failed) {
+            if (sources) {
+                sources->advance(begin, r.cur);
+            }
+            begin = r.cur;
+        } else if (sources) {
+            sources->truncate(recorded);
+        }
+        return finish_read(r, p);
+    }
+
+    read_result reader::try_read(std::istream& s)
+    {
+        source_map* const sources = options_.sources;
+        const size_t recorded = sources ? sources->size() : 0;
+
+        input base = { nullptr, nullptr, s.rdbuf(), &buffer_, false, false, ERR_EOS, sources, nullptr,
+                       options_, scratch_, frames_, values_ };
+        if (!s.good()) {
+            fail(base, ERR_EOS);
+            return finish_read(base, object_ptr());
+        }
+        stream_input r(s, base);
+        const object_ptr p = read_object(r);
+        if (sources) {
+            /* what was read is gone from the stream, even on an error */
+            sources->advance(r.origin, r.cur);
+            if (r.failed) {
+                sources->truncate(recorded);
+            }
+        }
+        return finish_read(r, p);
+    }
+
+    object_ptr reader::read(const char*& begin, const char* end)
+    {
+        const read_result result = try_read(begin, end);
+        ERROR_IF((result.status != READ_OBJECT), result.error);
+        return result.object;
+    }
+
+    object_ptr reader::read(std::istream& s)
+    {
+        const read_result result = try_read(s);
+        ERROR_IF((result.status != READ_OBJECT), result.error);
+        return result.object;
+    }
+
+    /* each thread reads with its own reader, so the free functions keep
+       their scratch space between calls without sharing it */
+    static reader& thread_reader()
+    {
+        static thread_local reader READER;
+        return READER;
+    }
+
+    object_ptr read_object(const char*& begin, const char* end)
+    {
+        return thread_reader().read(begin, end);
+    }
+
+    object_ptr read_object(std::istream& s)
+    {
+        return thread_reader().read(s);
+    }
+
+    read_result try_read_object(const char*& begin, const char* end)
+    {
+        return thread_reader().try_read(begin, end);
+    }
+
+    read_result try_read_object(std::istream& s)
+    {
+        return thread_reader().try_read(s);
+    }
+
+    /* everything but pairs and vectors */
+    static void print_atom(std::ostream& os, const object_ptr& p)
     {
         switch (p->type()) {
             case FIXNUM: {
-                os << p->fixnum();
+                char buf[FORMAT_BUFFER_SIZE];
+                os.write(buf, format_integer(p->fixnum(), buf));
+                break;
+            }
+            case BIGNUM: {
+                os << integer_to_string(p);
+                break;
+            }
+            case FLONUM: {
+                char buf[FORMAT_BUFFER_SIZE];
+                os.write(buf, format_double(p->flonum(), buf));
                 break;
             }
             case BOOLEAN: {
@@ -373,9 +907,9 @@ namespace uscheme {
                 os.put('"');
 
                 const char* str = p->string();
-                char ch;
-                while ((ch = *str)) {
-                    ++str;
+                const char* const end = str + p->string_length();
+                while (str != end) {
+                    const char ch = *str++;
                     switch (ch) {
                         case '\\' : {
                             os.put('\\').put('\\');
@@ -419,6 +953,152 @@ namespace uscheme {
                 os << "()";
                 break;
             }
+            case SYMBOL: {
+                os.write(p->symbol_name(), p->symbol_length());
+                break;
+            }
+            case PAIR:   /* fall through */
+            case VECTOR: {
+                break;
+            }
+        }
+    }
+
+    typedef std::unordered_map<const object*, long> print_labels;
+
+    /**
+     * Find the pairs and vectors that close a cycle: a depth-first walk
+     * over the cells reachable from p notes every edge back to a cell still
+     * on its path. Each gets a label, -1 until it is first printed.
+     */
+    static void find_cycles(const object_ptr& p, print_labels& labels)
+    {
+        struct walk_frame
+        {
+            object_ptr p;
+            size_t     next;
+        };
+
+        /* true while a cell is on the path, false once it is done */
+        std::unordered_map<const object*, bool> seen;
+        std::vector<walk_frame> path;
+        seen.emplace(p.get(), true);
+        path.push_back(walk_frame{ p, 0 });
+        while (!path.empty()) {
+            walk_frame& f = path.back();
+            const size_t count = f.p.is_pair() ? 2 : f.p.vector_length();
+            if (f.next == count) {
+                seen[f.p.get()] = false;
+                path.pop_back();
+                continue;
+            }
+            const object_ptr q = f.p.is_pair() ? ((f.next++ == 0) ? f.p.car() : f.p.cdr())
+                                               : f.p.vector_ref(f.next++);
+            if (!q.is_pair() && !q.is_vector()) {
+                continue;
+            }
+            const auto found = seen.emplace(q.get(), true);
+            if (found.second) {
+                path.push_back(walk_frame{ q, 0 });
+            } else if (found.first->second) {
+                labels.emplace(q.get(), -1);
+            }
+        }
+    }
+
+    /**
+     * Lists and vectors are printed without recursion, like they are read:
+     * each open one has a frame holding the pair whose car was printed last,
+     * or the vector and the index of its element printed last. Cycles are
+     * broken with datum labels, #n= where a labelled cell is first printed
+     * and #n# after that.
+     */
+    void print_object(std::ostream& os, const object_ptr& p)
+    {
+        struct print_frame
+        {
+            object_ptr p;
+            size_t     i; /* vector index, or 1 once a dotted tail is printed */
+        };
+
+        if (!p.is_pair() && !p.is_vector()) {
+            print_atom(os, p);
+            return;
+        }
+
+        print_labels labels;
+        find_cycles(p, labels);
+        long next_label = 0;
+
+        std::vector<print_frame> frames;
+        object_ptr q = p;
+        while (true) {
+            if (q.is_pair() || q.is_vector()) {
+                const auto label = labels.find(q.get());
+                bool open = true;
+                if (label != labels.end()) {
+                    if (label->second >= 0) {
+                        os << '#' << label->second << '#';
+                        open = false;
+                    } else {
+                        label->second = next_label++;
+                        os << '#' << label->second << '=';
+                    }
+                }
+                if (open && q.is_pair()) {
+                    os.put('(');
+                    frames.push_back(print_frame{ q, 0 });
+                    q = q.car();
+                    continue;
+                }
+                if (open) {
+                    os << "#(";
+                    if (q.vector_length() != 0) {
+                        frames.push_back(print_frame{ q, 0 });
+                        q = q.vector_ref(0);
+                        continue;
+                    }
+                    os.put(')');
+                }
+            } else {
+                print_atom(os, q);
+            }
+
+            /* q is printed; move on to the next element of the innermost
+               open list or vector, closing those that are done */
+            bool more = false;
+            while (!frames.empty() && !more) {
+                print_frame& f = frames.back();
+                if (f.p.is_vector()) {
+                    if (++f.i != f.p.vector_length()) {
+                        os.put(' ');
+                        q = f.p.vector_ref(f.i);
+                        more = true;
+                        continue;
+                    }
+                } else if (f.i == 0) {
+                    const object_ptr d = f.p.cdr();
+                    if (d.is_pair() && (labels.find(d.get()) == labels.end())) {
+                        os.put(' ');
+                        f.p = d;
+                        q = d.car();
+                        more = true;
+                        continue;
+                    }
+                    if (!d.is_empty_list()) {
+                        os << " . ";
+                        f.i = 1;
+                        q = d;
+                        more = true;
+                        continue;
+                    }
+                }
+                os.put(')');
+                frames.pop_back();
+            }
+            if (!more) {
+                return;
+            }
         }
     }
 
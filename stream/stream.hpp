@@ -32,8 +32,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define USCHEME_STREAM_STREAM_HPP
 
 // LANG includes
+#include <cstddef>
 #include <istream>
 #include <ostream>
+#include <string>
+#include <vector>
 
 // PKG includes
 #include <uscheme/defs.hpp>
@@ -42,21 +45,146 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace uscheme {
 
+    class literal_table;
+    class source_map;
+
     USCHEME_API
     /**
      *
      */
     void skip_line(std::istream& s);
 
-    USCHEME_API
     /**
+     * How a reader reads.
+     */
+    struct reader_options
+    {
+        reader_options()
+          : fold_case(false)
+          , sources(nullptr)
+          , literals(nullptr)
+        { }
+
+        bool           fold_case; /* read symbols, #T, #F and character names in lower case */
+        source_map*    sources;   /* where to record the position of each datum, if anywhere */
+        literal_table* literals;  /* where to share strings and numbers from, if anywhere */
+    };
+
+    /**
+     * A list or vector a reader has open; its elements so far start at
+     * index base of the reader's value stack.
+     */
+    struct reader_frame
+    {
+        enum frame_state { IN_LIST, IN_VECTOR, DOTTED_TAIL };
+
+        frame_state state;
+        size_t      base;
+        size_t      start; /* source offset of the open paren, if recorded */
+    };
+
+    /**
+     * How a read ended.
+     */
+    enum read_status
+    {
+        READ_OBJECT, /* an object was read */
+        READ_EOS,    /* the input ended first */
+        READ_ERROR   /* the input is malformed */
+    };
+
+    /**
+     * What a non-throwing read found: the object, or the reason there is
+     * none, which is what the throwing read would raise.
+     */
+    struct read_result
+    {
+        read_status status;
+        except_id   error;
+        object_ptr  object;
+    };
+
+    /**
+     * Reads objects from text. A reader owns its options and the scratch
+     * space reading needs, which it keeps from one call to the next, so
+     * readers on different threads are independent:
      *
+     *     uscheme::reader_options options;
+     *     options.fold_case = true;
+     *     uscheme::reader r(options);
+     *     uscheme::object_ptr p = r.read(cur, end);
+     *
+     * A single reader must not be used by two threads at once.
+     */
+    class USCHEME_API reader
+    {
+      public:
+        reader();
+
+        explicit reader(const reader_options& options);
+
+        const reader_options& options() const { return options_; }
+
+        /**
+         * Read one object from the characters in [begin, end), in place,
+         * and advance begin past it.
+         */
+        object_ptr read(const char*& begin, const char* end);
+
+        /**
+         * Read one object from s, leaving what follows it in the stream.
+         */
+        object_ptr read(std::istream& s);
+
+        /**
+         * Read as above, but report the end of input and malformed input
+         * in the result instead of throwing. After an error begin is left
+         * where it was, as with read.
+         */
+        read_result try_read(const char*& begin, const char* end);
+
+        read_result try_read(std::istream& s);
+
+      private:
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+
+        reader_options            options_;
+        std::string               scratch_; /* strings with escapes */
+        std::vector<char>         buffer_;  /* stream input */
+        std::vector<reader_frame> frames_;
+        std::vector<object_ptr>   values_;
+    };
+
+    USCHEME_API
+    /**
+     * Read one object from s with this thread's default reader.
      */
     object_ptr read_object(std::istream& s);
 
     USCHEME_API
     /**
-     *
+     * Read one object from the characters in [begin, end), in place, and
+     * advance begin past it, with this thread's default reader.
+     */
+    object_ptr read_object(const char*& begin, const char* end);
+
+    USCHEME_API
+    /**
+     * read_object without exceptions, with this thread's default reader.
+     */
+    read_result try_read_object(std::istream& s);
+
+    USCHEME_API
+    /**
+     * read_object without exceptions, with this thread's default reader.
+     */
+    read_result try_read_object(const char*& begin, const char* end);
+
+    USCHEME_API
+    /**
+     * Write p to os. Nesting depth is only bounded by memory; pairs and
+     * vectors that close a cycle are written with datum labels.
      */
     void print_object(std::ostream& os, const uscheme::object_ptr& p);
 
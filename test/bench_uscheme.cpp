@@ -0,0 +1,345 @@
+/**
+ * \file bench_uscheme.cpp
+ * \date 2015
+ *
+ * Timings, not tests: built with the tests but neither run by the build
+ * nor registered with ctest. Run it by hand, optionally with part of a
+ * benchmark name to run only the matching ones:
+ *
+ *     ./bench_uscheme reader
+ */
+
+// LANG includes
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// PKG includes
+#include <uscheme/type/object.hpp>
+#include <uscheme/type/number.hpp>
+#include <uscheme/stream/stream.hpp>
+#include <uscheme/stream/decimal.hpp>
+#include <uscheme/stream/scan.hpp>
+#include <uscheme/stream/parallel.hpp>
+#include <uscheme/stream/source.hpp>
+#include <uscheme/stream/literal.hpp>
+#include <uscheme/stream/fasl.hpp>
+#include <uscheme/gc/heap.hpp>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double seconds_since(bench_clock::time_point start)
+{
+    return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/* many top level data of every kind the reader handles */
+static std::string many_data(size_t count)
+{
+    std::string text;
+    for (size_t i = 0; i != count; ++i) {
+        const std::string n = std::to_string(i);
+        switch (i % 5) {
+            case 0: text += "(define (f" + n + " x) \"a (string) \\\" ;" + n + "\")\n"; break;
+            case 1: text += "; comment ( \" \n#(" + n + " #\\( #\\) #\\\" 2.5)\n"; break;
+            case 2: text += "(a (b (c . " + n + "))) sym" + n + " "; break;
+            case 3: text += "#\\space \"\" " + n + "12345678901234567890\t"; break;
+            default: text += "((#t #f) (-1.5e3 #\\;))\r\n"; break;
+        }
+    }
+    return text;
+}
+
+static size_t read_all(uscheme::reader& r, const std::string& text)
+{
+    const char* cur = text.data();
+    const char* const end = cur + text.size();
+    size_t n = 0;
+    while (r.try_read(cur, end).status == uscheme::READ_OBJECT) {
+        ++n;
+    }
+    return n;
+}
+
+static void bench_integer_add()
+{
+    /* the inline fixnum path next to plain long arithmetic */
+    const long N = 10000000;
+    auto t0 = bench_clock::now();
+    volatile long raw = 0;
+    for (long i = 0; i != N; ++i) {
+        raw = raw + i;
+    }
+    const double raw_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    uscheme::object_ptr sum = uscheme::object::create_fixnum(0);
+    for (long i = 0; i != N; ++i) {
+        sum = uscheme::integer_add(sum, uscheme::object::create_fixnum(i));
+    }
+    const double add_s = seconds_since(t0);
+    printf("long add: %.2f ns/op, integer_add: %.2f ns/op\n", raw_s * 1e9 / N, add_s * 1e9 / N);
+}
+
+static void bench_format_double()
+{
+    /* format_double next to a printf conversion that round-trips */
+    const int N = 1000000;
+    std::mt19937_64 rng(13);
+    std::vector<double> values(1024);
+    for (size_t i = 0; i != values.size(); ++i) {
+        values[i] = static_cast<double>(rng() % 100000000) / 1000;
+    }
+    char buf[uscheme::FORMAT_BUFFER_SIZE];
+    auto t0 = bench_clock::now();
+    for (int i = 0; i != N; ++i) {
+        snprintf(buf, sizeof(buf), "%.17g", values[i & 1023]);
+    }
+    const double printf_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    for (int i = 0; i != N; ++i) {
+        uscheme::format_double(values[i & 1023], buf);
+    }
+    const double format_s = seconds_since(t0);
+    printf("snprintf: %.2f ns/op, format_double: %.2f ns/op\n",
+           printf_s * 1e9 / N, format_s * 1e9 / N);
+}
+
+static void bench_parse_digits()
+{
+    /* digits on their own, next to one digit at a time, and as data */
+    std::mt19937 gen(5);
+    std::vector<std::string> numbers;
+    std::string text = "#(";
+    size_t ndigits = 0;
+    for (int i = 0; i != 1000000; ++i) {
+        numbers.push_back(std::to_string(gen() % 1000000000ull * 1000000000ull + gen()));
+        ndigits += numbers.back().size();
+        text += numbers.back() + " ";
+    }
+    text += ")";
+
+    volatile uint64_t sink = 0;
+    auto t0 = bench_clock::now();
+    for (size_t i = 0; i != numbers.size(); ++i) {
+        uint64_t value = 0;
+        uscheme::parse_digits(numbers[i].data(), numbers[i].data() + numbers[i].size(), 10, &value);
+        sink = sink + value;
+    }
+    const double fast_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    for (size_t i = 0; i != numbers.size(); ++i) {
+        uint64_t value = 0;
+        for (const char* p = numbers[i].data(); p != numbers[i].data() + numbers[i].size(); ++p) {
+            value = value * 10 + static_cast<unsigned>(*p - '0');
+        }
+        sink = sink + value;
+    }
+    const double slow_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    const char* cur = text.data();
+    uscheme::read_object(cur, text.data() + text.size());
+    const double read_s = seconds_since(t0);
+    printf("parse_digits: %.2f GB/s, one at a time: %.2f GB/s, read_object: %.2f GB/s\n",
+           ndigits / 1e9 / fast_s, ndigits / 1e9 / slow_s, text.size() / 1e9 / read_s);
+    uscheme::collect_garbage();
+}
+
+static void bench_reader()
+{
+    /* one large list from a span and from a stream */
+    std::string text = "(";
+    for (int i = 0; i != 100000; ++i) {
+        text += "(item " + std::to_string(i) + " \"value\" " + std::to_string(i) + ".5) ";
+    }
+    text += ")";
+    auto t0 = bench_clock::now();
+    const char* cur = text.data();
+    uscheme::read_object(cur, text.data() + text.size());
+    const double span_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    std::stringstream strm(text);
+    uscheme::read_object(strm);
+    const double stream_s = seconds_since(t0);
+    printf("reader span: %.1f MB/s, stream: %.1f MB/s\n",
+           text.size() / 1e6 / span_s, text.size() / 1e6 / stream_s);
+    uscheme::collect_garbage();
+}
+
+static void bench_reader_scan_levels()
+{
+    /* comment, indent and string heavy text at each scanner level */
+    std::string text = "(";
+    for (int i = 0; i != 20000; ++i) {
+        text += "\n        ; a comment explaining the next entry at some length\n"
+                "        \"a string value that is long enough to matter\"";
+    }
+    text += ")";
+    const uscheme::scan_level widest = uscheme::set_scan_level(uscheme::SCAN_AVX2);
+    for (int level = uscheme::SCAN_SCALAR; level <= widest; ++level) {
+        uscheme::set_scan_level(static_cast<uscheme::scan_level>(level));
+        const auto t0 = bench_clock::now();
+        const char* cur = text.data();
+        uscheme::read_object(cur, text.data() + text.size());
+        printf("reader scan level %d: %.1f MB/s\n", level, text.size() / 1e6 / seconds_since(t0));
+        uscheme::collect_garbage();
+    }
+    uscheme::set_scan_level(widest);
+}
+
+static void bench_reader_parallel()
+{
+    /* read_objects on more threads, against one */
+    const std::string text = many_data(400000);
+    double serial_s = 0;
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        const auto t0 = bench_clock::now();
+        uscheme::read_objects(text.data(), text.data() + text.size(), threads);
+        const double s = seconds_since(t0);
+        if (threads == 1) {
+            serial_s = s;
+        }
+        printf("reader %u threads: %.1f MB/s, %.2fx one thread\n",
+               threads, text.size() / 1e6 / s, serial_s / s);
+        uscheme::collect_garbage();
+    }
+}
+
+static void bench_reader_errors()
+{
+    /* malformed data: reporting by result against unwinding */
+    const std::string text = "(a b #q)";
+    const char* const end = text.data() + text.size();
+    const int rounds = 100000;
+    auto t0 = bench_clock::now();
+    for (int i = 0; i != rounds; ++i) {
+        const char* cur = text.data();
+        uscheme::try_read_object(cur, end);
+    }
+    const double returned_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    for (int i = 0; i != rounds; ++i) {
+        try {
+            const char* cur = text.data();
+            uscheme::read_object(cur, end);
+        } catch (const uscheme::exception&) {
+        }
+    }
+    const double thrown_s = seconds_since(t0);
+    printf("reader errors: %.0f ns returned, %.0f ns thrown\n",
+           returned_s * 1e9 / rounds, thrown_s * 1e9 / rounds);
+    uscheme::collect_garbage();
+}
+
+static void bench_reader_source_map()
+{
+    std::string text;
+    for (int i = 0; i != 20000; ++i) {
+        text += "(define (f x) (g \"str\" 1.5 x))\n";
+    }
+    for (int tracked = 0; tracked != 2; ++tracked) {
+        uscheme::source_map sources("bench.scm");
+        uscheme::reader_options options;
+        options.sources = tracked ? &sources : nullptr;
+        uscheme::reader r(options);
+        const auto t0 = bench_clock::now();
+        read_all(r, text);
+        printf("reader %s source map: %.1f MB/s, %zu spans\n", tracked ? "with" : "without",
+               text.size() / 1e6 / seconds_since(t0), sources.size());
+    }
+    uscheme::collect_garbage();
+}
+
+static void bench_reader_literals()
+{
+    std::string text;
+    for (int i = 0; i != 20000; ++i) {
+        text += "(define (f x) (g \"a string literal\" 1.5 x))\n";
+    }
+    for (int shared = 0; shared != 2; ++shared) {
+        uscheme::literal_table literals;
+        uscheme::reader_options options;
+        options.literals = shared ? &literals : nullptr;
+        uscheme::reader r(options);
+        const uscheme::gc_stats before = uscheme::gc_statistics();
+        const auto t0 = bench_clock::now();
+        read_all(r, text);
+        const double s = seconds_since(t0);
+        const uscheme::gc_stats after = uscheme::gc_statistics();
+        printf("reader %s literal table: %.1f MB/s, %zu KB allocated, %zu literals\n",
+               shared ? "with" : "without", text.size() / 1e6 / s,
+               (after.bytes_allocated - before.bytes_allocated) / 1024, literals.size());
+    }
+    uscheme::collect_garbage();
+}
+
+static void bench_fasl()
+{
+    /* loading fasl against parsing the same data as text */
+    const std::string text = many_data(200000);
+    std::string fasl;
+    {
+        std::stringstream out;
+        uscheme::fasl_writer w(out);
+        const char* cur = text.data();
+        const char* const end = cur + text.size();
+        uscheme::read_result result;
+        while ((result = uscheme::try_read_object(cur, end)).status == uscheme::READ_OBJECT) {
+            w.write(result.object);
+        }
+        w.flush();
+        fasl = out.str();
+    }
+    uscheme::collect_garbage();
+
+    uscheme::reader r;
+    auto t0 = bench_clock::now();
+    const size_t parsed = read_all(r, text);
+    const double text_s = seconds_since(t0);
+    uscheme::collect_garbage();
+
+    t0 = bench_clock::now();
+    uscheme::fasl_reader f(fasl.data(), fasl.data() + fasl.size());
+    size_t loaded = 0;
+    while (f.try_read().status == uscheme::READ_OBJECT) {
+        ++loaded;
+    }
+    const double fasl_s = seconds_since(t0);
+    printf("fasl: text %zu KB, %.2f M data/s; fasl %zu KB, %.2f M data/s (%.2fx)%s\n",
+           text.size() / 1024, parsed / text_s / 1e6, fasl.size() / 1024,
+           loaded / fasl_s / 1e6, text_s / fasl_s, (loaded == parsed) ? "" : ", COUNTS DIFFER");
+    uscheme::collect_garbage();
+}
+
+struct benchmark
+{
+    const char* name;
+    void      (*run)();
+};
+
+static const benchmark BENCHMARKS[] = {
+    { "integer_add",         bench_integer_add },
+    { "format_double",       bench_format_double },
+    { "parse_digits",        bench_parse_digits },
+    { "reader",              bench_reader },
+    { "reader_scan_levels",  bench_reader_scan_levels },
+    { "reader_parallel",     bench_reader_parallel },
+    { "reader_errors",       bench_reader_errors },
+    { "reader_source_map",   bench_reader_source_map },
+    { "reader_literals",     bench_reader_literals },
+    { "fasl",                bench_fasl },
+};
+
+int main(int argc, char* argv[])
+{
+    const char* filter = (argc > 1) ? argv[1] : "";
+    for (size_t i = 0; i != sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]); ++i) {
+        if (strstr(BENCHMARKS[i].name, filter)) {
+            BENCHMARKS[i].run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * \file test_uscheme_gc.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <cstring>
+#include <cstdio>
+
+// TEST includes
+#include "unittest.hpp"
+
+// PKG includes
+#include <uscheme/type/object.hpp>
+#include <uscheme/gc/heap.hpp>
+#include <uscheme/gc/slab.hpp>
+#include <uscheme/type/vector.hpp>
+
+CPP_TEST( gc_collect_unreachable )
+{
+    uscheme::collect_garbage();
+    const uscheme::gc_stats before = uscheme::gc_statistics();
+
+    for (int i = 0; i != 1000; ++i) {
+        uscheme::object::create_string("garbage");
+    }
+    TEST_TRUE( uscheme::gc_statistics().objects_live == before.objects_live + 1000 );
+
+    uscheme::collect_garbage();
+    const uscheme::gc_stats after = uscheme::gc_statistics();
+    TEST_TRUE( after.objects_live == before.objects_live );
+    TEST_TRUE( after.objects_freed == before.objects_freed + 1000 );
+    TEST_TRUE( after.collections == before.collections + 1 );
+}
+
+CPP_TEST( gc_roots_survive )
+{
+    uscheme::object_ptr kept = uscheme::object::create_string("kept");
+    uscheme::object_ptr immediate = uscheme::object::create_fixnum(42);
+    {
+        uscheme::gc_root r1(kept);
+        uscheme::gc_root r2(immediate);
+
+        for (int i = 0; i != 100; ++i) {
+            uscheme::object::create_string("garbage");
+        }
+        uscheme::collect_garbage();
+        TEST_TRUE( strcmp(kept->string(), "kept") == 0 );
+        TEST_TRUE( immediate->fixnum() == 42 );
+
+        /* reassigning a rooted slot roots the new value */
+        kept = uscheme::object::create_string("replaced");
+        uscheme::collect_garbage();
+        TEST_TRUE( strcmp(kept->string(), "replaced") == 0 );
+    }
+
+    const size_t live = uscheme::gc_statistics().objects_live;
+    uscheme::collect_garbage();
+    TEST_TRUE( uscheme::gc_statistics().objects_live + 1 == live );
+}
+
+CPP_TEST( gc_minor_promotes_survivors )
+{
+    uscheme::collect_young_garbage();
+    const uscheme::gc_stats before = uscheme::gc_statistics();
+
+    uscheme::object_ptr kept = uscheme::object::create_string("kept");
+    uscheme::gc_root r(kept);
+    TEST_TRUE( uscheme::gc_is_young(kept.get()) );
+
+    for (int i = 0; i != 1000; ++i) {
+        uscheme::object::create_string("garbage");
+    }
+
+    const uscheme::object* young = kept.get();
+    uscheme::collect_young_garbage();
+    const uscheme::gc_stats after = uscheme::gc_statistics();
+
+    /* the rooted cell moved out of the nursery and the slot followed it */
+    TEST_TRUE( kept.get() != young );
+    TEST_TRUE( !uscheme::gc_is_young(kept.get()) );
+    TEST_TRUE( strcmp(kept->string(), "kept") == 0 );
+
+    TEST_TRUE( after.minor_collections == before.minor_collections + 1 );
+    TEST_TRUE( after.collections == before.collections );
+    TEST_TRUE( after.objects_freed == before.objects_freed + 1000 );
+    TEST_TRUE( after.objects_live == before.objects_live + 1 );
+    TEST_TRUE( after.bytes_promoted > before.bytes_promoted );
+    TEST_TRUE( after.minor_pause_max_ns >= before.minor_pause_max_ns );
+}
+
+CPP_TEST( gc_nursery_overflow )
+{
+    uscheme::collect_garbage();
+    const uscheme::gc_stats before = uscheme::gc_statistics();
+
+    /* more than the nursery holds; the rest is allocated old */
+    for (int i = 0; i != 100000; ++i) {
+        uscheme::object::create_string("garbage");
+    }
+    TEST_TRUE( uscheme::gc_statistics().objects_live == before.objects_live + 100000 );
+
+    uscheme::gc_safepoint();
+    TEST_TRUE( uscheme::gc_statistics().minor_collections > before.minor_collections );
+
+    uscheme::collect_garbage();
+    TEST_TRUE( uscheme::gc_statistics().objects_live == before.objects_live );
+}
+
+CPP_TEST( gc_nursery_overflow_references_young )
+{
+    uscheme::collect_young_garbage();
+    uscheme::object_ptr young = uscheme::object::create_string("young");
+    uscheme::object_ptr later = uscheme::object::create_string("later");
+    uscheme::gc_root r1(later);
+    uscheme::object_ptr pair;
+    {
+        uscheme::gc_root r2(young);
+        for (int i = 0; i != 100000; ++i) {
+            uscheme::object::create_string("garbage");
+        }
+        /* allocated old while the nursery is full, built without a barrier */
+        pair = uscheme::object::create_pair(young, uscheme::empty_list_value());
+        TEST_TRUE( !uscheme::gc_is_young(pair.get()) );
+    }
+    uscheme::gc_root r3(pair);
+
+    /* a barrier store must still record the cell in the remembered set */
+    pair->set_cdr(later);
+    uscheme::collect_young_garbage();
+    TEST_TRUE( strcmp(pair->car()->string(), "young") == 0 );
+    TEST_TRUE( !uscheme::gc_is_young(pair->car().get()) );
+    TEST_TRUE( pair->cdr().get() == later.get() );
+
+    later = uscheme::object::create_string("replaced");
+    pair->set_cdr(later);
+    uscheme::collect_young_garbage();
+    TEST_TRUE( strcmp(pair->cdr()->string(), "replaced") == 0 );
+    TEST_TRUE( !uscheme::gc_is_young(pair->cdr().get()) );
+}
+
+CPP_TEST( slab_reuses_freed_cells )
+{
+    void* a = uscheme::slab_allocate(16);
+    void* b = uscheme::slab_allocate(16);
+    TEST_TRUE( a != b );
+    TEST_TRUE( (reinterpret_cast<uintptr_t>(a) & 0x0f) == 0 );
+
+    /* freed cells come back first, from their own size class */
+    uscheme::slab_free(a, 16);
+    void* c = uscheme::slab_allocate(40);
+    TEST_TRUE( c != a );
+    TEST_TRUE( uscheme::slab_allocate(10) == a );
+
+    void* big = uscheme::slab_allocate(uscheme::SLAB_MAX_SIZE + 1);
+    memset(big, 0, uscheme::SLAB_MAX_SIZE + 1);
+    uscheme::slab_free(big, uscheme::SLAB_MAX_SIZE + 1);
+
+    uscheme::slab_free(b, 16);
+    uscheme::slab_free(c, 40);
+}
+
+CPP_TEST( gc_pairs_and_cycles )
+{
+    uscheme::collect_garbage();
+    const uscheme::gc_stats before = uscheme::gc_statistics();
+
+    uscheme::object_ptr kept = uscheme::object::create_pair(
+        uscheme::object::create_string("car"), uscheme::empty_list_value());
+    kept->set_cdr(kept);
+    {
+        /* an unrooted cycle */
+        auto c = uscheme::object::create_pair(uscheme::empty_list_value(),
+                                              uscheme::empty_list_value());
+        c->set_cdr(c);
+    }
+
+    uscheme::gc_root r(kept);
+    uscheme::collect_young_garbage();
+    TEST_TRUE( !uscheme::gc_is_young(kept.get()) );
+    TEST_TRUE( kept->cdr().get() == kept.get() );
+    TEST_TRUE( !uscheme::gc_is_young(kept->car().get()) );
+    TEST_TRUE( strcmp(kept->car()->string(), "car") == 0 );
+
+    /* an old pair pointing at a young cell is found through the barrier */
+    kept->set_car(uscheme::object::create_string("young"));
+    uscheme::collect_young_garbage();
+    TEST_TRUE( !uscheme::gc_is_young(kept->car().get()) );
+    TEST_TRUE( strcmp(kept->car()->string(), "young") == 0 );
+
+    uscheme::collect_garbage();
+    TEST_TRUE( uscheme::gc_statistics().objects_live == before.objects_live + 2 );
+    TEST_TRUE( kept->cdr().get() == kept.get() );
+}
+
+CPP_TEST( gc_vector_bulk_stores )
+{
+    uscheme::object_ptr v = uscheme::make_vector(100, uscheme::empty_list_value());
+    uscheme::gc_root r(v);
+    uscheme::collect_young_garbage();
+    TEST_TRUE( !uscheme::gc_is_young(v.get()) );
+
+    /* young cells stored into an old vector by the bulk primitives */
+    uscheme::vector_fill(v, uscheme::object::create_string("fill"), 0, 50);
+    uscheme::object_ptr w = uscheme::make_vector(2, uscheme::object::create_string("copy"));
+    uscheme::vector_copy(v, 98, w, 0, 2);
+
+    uscheme::collect_young_garbage();
+    TEST_TRUE( strcmp(v->vector_ref(0)->string(), "fill") == 0 );
+    TEST_TRUE( v->vector_ref(0).get() == v->vector_ref(49).get() );
+    TEST_TRUE( !uscheme::gc_is_young(v->vector_ref(49).get()) );
+    TEST_TRUE( v->vector_ref(50)->is_empty_list() );
+    TEST_TRUE( strcmp(v->vector_ref(99)->string(), "copy") == 0 );
+
+    uscheme::collect_garbage();
+    TEST_TRUE( strcmp(v->vector_ref(98)->string(), "copy") == 0 );
+}
@@ -0,0 +1,372 @@
+/**
+ * \file test_uscheme_number.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// TEST includes
+#include "unittest.hpp"
+
+// PKG includes
+#include <uscheme/type/number.hpp>
+#include <uscheme/stream/stream.hpp>
+#include <uscheme/stream/decimal.hpp>
+#include <uscheme/gc/heap.hpp>
+
+static uscheme::object_ptr read_integer(const std::string& s)
+{
+    return uscheme::integer_from_decimal(s.data() + (s[0] == '-'),
+                                         s.size() - (s[0] == '-'), s[0] == '-');
+}
+
+CPP_TEST( integer_fixnum_boundary )
+{
+    const long max = uscheme::object_ptr::FIXNUM_MAX;
+    const long min = uscheme::object_ptr::FIXNUM_MIN;
+    auto one = uscheme::object::create_fixnum(1);
+
+    auto p = uscheme::integer_add(uscheme::object::create_fixnum(max), one);
+    TEST_TRUE( p->is_bignum() );
+    TEST_TRUE( !p->bignum_negative() );
+
+    /* and back down to a fixnum */
+    auto q = uscheme::integer_sub(p, one);
+    TEST_TRUE( q->is_fixnum() && q->fixnum() == max );
+
+    auto n = uscheme::integer_sub(uscheme::object::create_fixnum(min), one);
+    TEST_TRUE( n->is_bignum() && n->bignum_negative() );
+    TEST_TRUE( uscheme::integer_compare(n, uscheme::object::create_fixnum(min)) < 0 );
+    TEST_TRUE( uscheme::integer_compare(p, n) > 0 );
+
+    TEST_TRUE( uscheme::make_integer(5)->fixnum() == 5 );
+    TEST_TRUE( uscheme::integer_to_string(uscheme::integer_sub(p, p)) == "0" );
+    TEST_TRUE( uscheme::integer_add(p, n)->is_fixnum() );
+    TEST_TRUE( uscheme::integer_add(p, n)->fixnum() == -1 );
+
+    try {
+        uscheme::integer_add(one, uscheme::true_value());
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_NOT_INT );
+    }
+}
+
+CPP_TEST( integer_bignum_arithmetic )
+{
+    auto a = read_integer("123456789012345678901234567890");
+    auto b = read_integer("-987654321098765432109876543210");
+    TEST_TRUE( uscheme::integer_to_string(a) == "123456789012345678901234567890" );
+    TEST_TRUE( uscheme::integer_to_string(b) == "-987654321098765432109876543210" );
+    TEST_TRUE( uscheme::integer_to_string(uscheme::integer_add(a, b))
+               == "-864197532086419753208641975320" );
+    TEST_TRUE( uscheme::integer_to_string(uscheme::integer_sub(a, b))
+               == "1111111110111111111011111111100" );
+    TEST_TRUE( uscheme::integer_to_string(uscheme::integer_mul(a, b))
+               == "-121932631137021795226185032733622923332237463801111263526900" );
+
+    /* bignum cells move out of the nursery intact */
+    uscheme::gc_root r(a);
+    uscheme::collect_garbage();
+    TEST_TRUE( uscheme::integer_to_string(a) == "123456789012345678901234567890" );
+}
+
+CPP_TEST( integer_karatsuba )
+{
+    /* (10^n - 1)^2 = 99..9800..01, large enough to take the Karatsuba path */
+    for (size_t n = 300; n <= 2000; n += 850) {
+        auto x = read_integer(std::string(n, '9'));
+        const std::string expect =
+            std::string(n - 1, '9') + "8" + std::string(n - 1, '0') + "1";
+        TEST_TRUE( uscheme::integer_to_string(uscheme::integer_mul(x, x)) == expect );
+    }
+
+    /* unbalanced operands */
+    auto big = read_integer("1" + std::string(3000, '0'));
+    auto mid = read_integer("-" + std::string(400, '9'));
+    TEST_TRUE( uscheme::integer_to_string(uscheme::integer_mul(big, mid))
+               == "-" + std::string(400, '9') + std::string(3000, '0') );
+}
+
+CPP_TEST( integer_read_print )
+{
+    const char* cases[] = {
+        "4611686018427387903",
+        "4611686018427387904",
+        "-9223372036854775808",
+        "99999999999999999999999999999999999999",
+    };
+    for (size_t i = 0; i != sizeof(cases) / sizeof(cases[0]); ++i) {
+        std::stringstream strm;
+        strm << cases[i];
+        std::stringstream os;
+        uscheme::print_object(os, uscheme::read_object(strm));
+        TEST_TRUE( os.str() == cases[i] );
+    }
+
+    std::stringstream strm;
+    strm << "+000000000000000000000000000012";
+    auto p = uscheme::read_object(strm);
+    TEST_TRUE( p->is_fixnum() && p->fixnum() == 12 );
+}
+
+static bool same_double(double a, double b)
+{
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+CPP_TEST( parse_double_matches_strtod )
+{
+    const char* fixed[] = {
+        "0", "0.0", "-0.0", "1", "0.1", "0.3", "123.456", "1e23", "8.5e-5",
+        "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1.7976931348623157e308",
+        "1.7976931348623159e308", "1e400", "1e-400",
+        "9007199254740993", "9007199254740992.999999999999999999999",
+        "7.2057594037927933e16", "123456789012345678901234567890e-10",
+        "0.000000000000000000000000000000000000001234567890123456789012",
+    };
+    for (size_t i = 0; i != sizeof(fixed) / sizeof(fixed[0]); ++i) {
+        double value;
+        TEST_TRUE( uscheme::parse_double(fixed[i], fixed[i] + strlen(fixed[i]), &value) );
+        TEST_TRUE( same_double(value, strtod(fixed[i], nullptr)) );
+    }
+
+    /* random digit strings of up to 25 digits with exponents spanning the
+       normal and subnormal ranges */
+    std::mt19937_64 rng(2015);
+    for (int n = 0; n != 200000; ++n) {
+        std::string text;
+        if (rng() & 1) {
+            text.push_back('-');
+        }
+        const int digits = 1 + static_cast<int>(rng() % 25);
+        const int point = static_cast<int>(rng() % (digits + 1));
+        for (int i = 0; i != digits; ++i) {
+            if (i == point) {
+                text.push_back('.');
+            }
+            text.push_back(static_cast<char>('0' + rng() % 10));
+        }
+        if (rng() & 1) {
+            text += "e" + std::to_string(static_cast<int>(rng() % 660) - 340);
+        }
+
+        double value;
+        bool ok = uscheme::parse_double(text.data(), text.data() + text.size(), &value);
+        TEST_TRUE( ok );
+        if (!ok || !same_double(value, strtod(text.c_str(), nullptr))) {
+            printf("parse_double mismatch: %s\n", text.c_str());
+            break;
+        }
+    }
+
+    const char* bad[] = { "", "-", ".", "e5", "1e", "1e+", "1.2.3", "1x", "--1" };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        double value;
+        TEST_TRUE( !uscheme::parse_double(bad[i], bad[i] + strlen(bad[i]), &value) );
+    }
+}
+
+static std::string format_integer(long value)
+{
+    char buf[uscheme::FORMAT_BUFFER_SIZE];
+    return std::string(buf, uscheme::format_integer(value, buf));
+}
+
+static std::string format_double(double value)
+{
+    char buf[uscheme::FORMAT_BUFFER_SIZE];
+    return std::string(buf, uscheme::format_double(value, buf));
+}
+
+CPP_TEST( format_integer_digits )
+{
+    TEST_TRUE( format_integer(0) == "0" );
+    TEST_TRUE( format_integer(7) == "7" );
+    TEST_TRUE( format_integer(-10) == "-10" );
+    TEST_TRUE( format_integer(100) == "100" );
+    TEST_TRUE( format_integer(LONG_MAX) == std::to_string(LONG_MAX) );
+    TEST_TRUE( format_integer(LONG_MIN) == std::to_string(LONG_MIN) );
+
+    std::mt19937_64 rng(11);
+    for (int n = 0; n != 100000; ++n) {
+        const long v = static_cast<long>(rng()) >> (rng() % 64);
+        TEST_TRUE( format_integer(v) == std::to_string(v) );
+    }
+
+    /* chunks inside a bignum keep their leading zeros */
+    TEST_TRUE( uscheme::integer_to_string(
+                   read_integer("-1000000000000000000000000000007")) ==
+               "-1000000000000000000000000000007" );
+}
+
+CPP_TEST( format_double_round_trip )
+{
+    TEST_TRUE( format_double(0.0) == "0.0" );
+    TEST_TRUE( format_double(-0.0) == "-0.0" );
+    TEST_TRUE( format_double(1.0) == "1.0" );
+    TEST_TRUE( format_double(-2.5) == "-2.5" );
+    TEST_TRUE( format_double(0.1) == "0.1" );
+    TEST_TRUE( format_double(0.3) == "0.3" );
+    TEST_TRUE( format_double(0.1 + 0.2) == "0.30000000000000004" );
+    TEST_TRUE( format_double(1e20) == "100000000000000000000.0" );
+    TEST_TRUE( format_double(1e21) == "1e21" );
+    TEST_TRUE( format_double(1e22) == "1e22" );
+    TEST_TRUE( format_double(1e23) == "1e23" );
+    TEST_TRUE( format_double(0.00001) == "0.00001" );
+    TEST_TRUE( format_double(1.5e-7) == "1.5e-7" );
+    TEST_TRUE( format_double(5e-324) == "5e-324" );
+    TEST_TRUE( format_double(1.7976931348623157e308) == "1.7976931348623157e308" );
+    TEST_TRUE( format_double(2.2250738585072014e-308) == "2.2250738585072014e-308" );
+    TEST_TRUE( format_double(HUGE_VAL) == "+inf.0" );
+    TEST_TRUE( format_double(-HUGE_VAL) == "-inf.0" );
+    TEST_TRUE( format_double(NAN) == "+nan.0" );
+
+    /* every bit pattern reads back, and never needs more than 17 digits */
+    std::mt19937_64 rng(12);
+    for (int n = 0; n != 200000; ++n) {
+        const uint64_t bits = rng();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        const std::string text = format_double(value);
+        double back;
+        TEST_TRUE( uscheme::parse_double(text.data(), text.data() + text.size(), &back) );
+        TEST_TRUE( same_double(back, value) );
+        if (!same_double(back, value)) {
+            printf("format_double mismatch: %s\n", text.c_str());
+            break;
+        }
+
+        /* and no shorter decimal would do */
+        if ((n % 10) == 0) {
+            std::string digits;
+            for (size_t i = 0; (i != text.size()) && (text[i] != 'e'); ++i) {
+                if (isdigit(text[i])) {
+                    digits.push_back(text[i]);
+                }
+            }
+            digits.erase(0, digits.find_first_not_of('0'));
+            digits.erase(digits.find_last_not_of('0') + 1);
+            char shorter[32];
+            snprintf(shorter, sizeof(shorter), "%.*e",
+                     static_cast<int>(digits.size()) - 2, value);
+            TEST_TRUE( (digits.size() == 1) || (strtod(shorter, nullptr) != value) );
+        }
+    }
+}
+
+/* one digit at a time with an exact overflow check, as a reference */
+static const char* parse_digits_slowly(const char* p, const char* end, unsigned radix,
+                                       uint64_t* value)
+{
+    for (; p != end; ++p) {
+        const unsigned d = uscheme::digit_value(*p);
+        if ((d >= radix) || (*value > (UINT64_MAX - d) / radix)) {
+            break;
+        }
+        *value = *value * radix + d;
+    }
+    return p;
+}
+
+CPP_TEST( parse_digits_exact )
+{
+    const unsigned radixes[] = { 2, 8, 10, 16 };
+    const char alphabet[] = "0123456789abcdefABCDEF9999999900 .x";
+    std::mt19937 gen(11);
+    std::string text(64, '0');
+    for (int round = 0; round != 20000; ++round) {
+        /* mostly digits, so that runs cross the 8 byte blocks */
+        const size_t length = gen() % text.size();
+        for (size_t i = 0; i != length; ++i) {
+            text[i] = (gen() % 16) ? alphabet[gen() % 26] : alphabet[gen() % (sizeof(alphabet) - 1)];
+        }
+        const unsigned radix = radixes[gen() % 4];
+        uint64_t expected = 0;
+        uint64_t value = 0;
+        const char* end = text.data() + length;
+        TEST_TRUE( uscheme::parse_digits(text.data(), end, radix, &value) ==
+                   parse_digits_slowly(text.data(), end, radix, &expected) );
+        TEST_TRUE( value == expected );
+    }
+
+    const std::string max = "18446744073709551615";
+    uint64_t value = 0;
+    TEST_TRUE( uscheme::parse_digits(max.data(), max.data() + max.size(), 10, &value) ==
+               max.data() + max.size() );
+    TEST_TRUE( value == UINT64_MAX );
+
+    /* stops before the digit that overflows */
+    const std::string over = "18446744073709551616";
+    value = 0;
+    TEST_TRUE( uscheme::parse_digits(over.data(), over.data() + over.size(), 10, &value) ==
+               over.data() + 19 );
+    TEST_TRUE( value == 1844674407370955161ull );
+
+    const std::string hex = "fFfFfFfFfFfFfFfF0";
+    value = 0;
+    TEST_TRUE( uscheme::parse_digits(hex.data(), hex.data() + hex.size(), 16, &value) ==
+               hex.data() + 16 );
+    TEST_TRUE( value == UINT64_MAX );
+}
+
+CPP_TEST( integer_radix_literals )
+{
+    const char* cases[][2] = {
+        { "#xff", "255" },
+        { "#XfF", "255" },
+        { "#x-10", "-16" },
+        { "#b+101", "5" },
+        { "#o777", "511" },
+        { "#d42", "42" },
+        { "#d-1.5", "-1.5" },
+        { "#x7fffffffffffffff", "9223372036854775807" },
+        { "#x-8000000000000000", "-9223372036854775808" },
+        { "#x10000000000000000", "18446744073709551616" },
+        { "#b11111111111111111111111111111111111111111111111111111111111111111", "36893488147419103231" },
+        { "9223372036854775807", "9223372036854775807" },
+        { "9223372036854775808", "9223372036854775808" },
+        { "-9223372036854775809", "-9223372036854775809" },
+        { "123456789012345678", "123456789012345678" },
+        { "(#x1f #b10 . #o10)", "(31 2 . 8)" },
+    };
+    for (size_t i = 0; i != sizeof(cases) / sizeof(cases[0]); ++i) {
+        std::stringstream strm;
+        strm << cases[i][0];
+        std::stringstream os;
+        uscheme::print_object(os, uscheme::read_object(strm));
+        TEST_TRUE( os.str() == cases[i][1] );
+    }
+
+    const char* bad[] = { "#x", "#x-", "#xfg", "#b102", "#o8", "#x1.5", "#d" };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        const char* cur = bad[i];
+        const uscheme::read_result result = uscheme::try_read_object(cur, cur + strlen(cur));
+        TEST_TRUE( result.status == uscheme::READ_ERROR );
+        TEST_TRUE( result.error == uscheme::ERR_TERM_NUM );
+    }
+
+    /* a bare prefix filling an exact-size buffer, with nothing after it */
+    const char* prefixes[] = { "#x", "#b", "#o", "#d" };
+    for (size_t i = 0; i != sizeof(prefixes) / sizeof(prefixes[0]); ++i) {
+        std::vector<char> exact(prefixes[i], prefixes[i] + 2);
+        const char* cur = exact.data();
+        const uscheme::read_result result = uscheme::try_read_object(cur, exact.data() + exact.size());
+        TEST_TRUE( result.status == uscheme::READ_ERROR );
+        TEST_TRUE( result.error == uscheme::ERR_TERM_NUM );
+    }
+}
@@ -0,0 +1,254 @@
+/**
+ * \file test_uscheme_object.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// TEST includes
+#include "unittest.hpp"
+
+// PKG includes
+#include <uscheme/type/object.hpp>
+#include <uscheme/type/vector.hpp>
+#include <uscheme/type/number.hpp>
+
+CPP_TEST( object_immediates )
+{
+    {
+        auto p = uscheme::object::create_fixnum(uscheme::object_ptr::FIXNUM_MAX);
+        TEST_TRUE( !p.is_heap() );
+        TEST_TRUE( p->type() == uscheme::FIXNUM );
+        TEST_TRUE( p->fixnum() == uscheme::object_ptr::FIXNUM_MAX );
+
+        auto q = uscheme::object::create_fixnum(uscheme::object_ptr::FIXNUM_MIN);
+        TEST_TRUE( q->fixnum() == uscheme::object_ptr::FIXNUM_MIN );
+
+        auto z = uscheme::object::create_fixnum(0);
+        TEST_TRUE( z->is_fixnum() );
+        TEST_TRUE( !z->is_boolean() && !z->is_character() && !z->is_empty_list() );
+        TEST_TRUE( z->fixnum() == 0 );
+    }
+    if (uscheme::object_ptr::FIXNUM_MAX < LONG_MAX) {
+        /* longs outside the fixnum range keep their value as bignums */
+        const long above = uscheme::object_ptr::FIXNUM_MAX + 1;
+        auto p = uscheme::object::create_fixnum(above);
+        TEST_TRUE( p.is_heap() && p->is_bignum() );
+        TEST_TRUE( uscheme::integer_to_string(p) == std::to_string(above) );
+
+        const long below = uscheme::object_ptr::FIXNUM_MIN - 1;
+        auto q = uscheme::object::create_fixnum(below);
+        TEST_TRUE( q->is_bignum() );
+        TEST_TRUE( uscheme::integer_to_string(q) == std::to_string(below) );
+        TEST_TRUE( uscheme::integer_compare(q, uscheme::make_integer(below)) == 0 );
+
+        auto r = uscheme::object::create_fixnum(LONG_MIN);
+        TEST_TRUE( uscheme::integer_to_string(r) == std::to_string(LONG_MIN) );
+    }
+
+    {
+        auto p = uscheme::object::create_character('\xff');
+        TEST_TRUE( !p.is_heap() );
+        TEST_TRUE( p->type() == uscheme::CHARACTER );
+        TEST_TRUE( p->character() == '\xff' );
+        TEST_TRUE( !p->is_fixnum() && !p->is_boolean() );
+    }
+
+    {
+        auto t = uscheme::object::create_boolean(true);
+        auto f = uscheme::object::create_boolean(false);
+        TEST_TRUE( t.get() == uscheme::true_value().get() );
+        TEST_TRUE( f.get() == uscheme::false_value().get() );
+        TEST_TRUE( t->type() == uscheme::BOOLEAN && f->type() == uscheme::BOOLEAN );
+        TEST_TRUE( t->boolean() && !f->boolean() );
+    }
+
+    {
+        auto e = uscheme::object::create_empty_list();
+        TEST_TRUE( !e.is_heap() );
+        TEST_TRUE( e->type() == uscheme::EMPTY_LIST );
+        TEST_TRUE( e.get() == uscheme::empty_list_value().get() );
+    }
+}
+
+CPP_TEST( object_string )
+{
+    auto p = uscheme::object::create_string("foo");
+    TEST_TRUE( p.is_heap() );
+    TEST_TRUE( p->type() == uscheme::STRING );
+    TEST_TRUE( p->is_string() );
+    TEST_TRUE( !p->is_fixnum() && !p->is_empty_list() );
+    TEST_TRUE( strcmp(p->string(), "foo") == 0 );
+
+    uscheme::object_ptr q = p;
+    TEST_TRUE( q.get() == p.get() );
+    p = uscheme::object::create_fixnum(1);
+    TEST_TRUE( strcmp(q->string(), "foo") == 0 );
+}
+
+CPP_TEST( object_string_inline )
+{
+    const std::string shrt(uscheme::object::STRING_INLINE_MAX, 'a');
+    const std::string lng(uscheme::object::STRING_INLINE_MAX + 1, 'b');
+
+    auto e = uscheme::object::create_string("");
+    TEST_TRUE( e->string_length() == 0 );
+    TEST_TRUE( e->string()[0] == '\0' );
+
+    auto s = uscheme::object::create_string(shrt.c_str());
+    auto l = uscheme::object::create_string(lng.c_str());
+    TEST_TRUE( s->string_length() == shrt.size() );
+    TEST_TRUE( l->string_length() == lng.size() );
+    TEST_TRUE( shrt == s->string() );
+    TEST_TRUE( lng == l->string() );
+
+    /* inline characters live in the cell, long ones do not */
+    const char* cell = reinterpret_cast<const char*>(s.get());
+    TEST_TRUE( s->string() > cell && s->string() < cell + 32 );
+
+    /* both kinds survive being copied out of the nursery */
+    uscheme::gc_root rs(s);
+    uscheme::gc_root rl(l);
+    uscheme::collect_young_garbage();
+    TEST_TRUE( shrt == s->string() );
+    TEST_TRUE( lng == l->string() );
+    uscheme::collect_garbage();
+    TEST_TRUE( shrt == s->string() );
+    TEST_TRUE( lng == l->string() );
+
+    /* the length is explicit, so embedded NULs are kept */
+    auto z = uscheme::object::create_string("a\0b", 3);
+    TEST_TRUE( z->string_length() == 3 );
+    TEST_TRUE( memcmp(z->string(), "a\0b", 4) == 0 );
+}
+
+CPP_TEST( object_symbol )
+{
+    auto a = uscheme::object::create_symbol("lambda");
+    auto b = uscheme::object::create_symbol("lambda-x", 6);
+    auto c = uscheme::object::create_symbol("lambda-x");
+
+    TEST_TRUE( !a.is_heap() );
+    TEST_TRUE( a->is_symbol() && !a->is_string() && !a->is_fixnum() );
+    TEST_TRUE( a->type() == uscheme::SYMBOL );
+    TEST_TRUE( a->symbol_length() == 6 );
+    TEST_TRUE( strcmp(a->symbol_name(), "lambda") == 0 );
+
+    /* one record per name, so eq? is a word compare */
+    TEST_TRUE( a.bits() == b.bits() );
+    TEST_TRUE( a.bits() != c.bits() );
+
+    /* enough names to grow the table; earlier ones keep their identity */
+    char name[32];
+    for (int i = 0; i != 5000; ++i) {
+        snprintf(name, sizeof(name), "sym-%d", i);
+        uscheme::object::create_symbol(name);
+    }
+    TEST_TRUE( uscheme::symbol_count() >= 5000 );
+    TEST_TRUE( uscheme::object::create_symbol("lambda").bits() == a.bits() );
+    snprintf(name, sizeof(name), "sym-%d", 1234);
+    TEST_TRUE( strcmp(uscheme::object::create_symbol(name)->symbol_name(), name) == 0 );
+}
+
+CPP_TEST( object_pair )
+{
+    auto a = uscheme::object::create_fixnum(1);
+    auto s = uscheme::object::create_string("two");
+    auto p = uscheme::object::create_pair(a, s);
+    TEST_TRUE( p.is_heap() );
+    TEST_TRUE( p->type() == uscheme::PAIR );
+    TEST_TRUE( p->is_pair() && !p->is_string() );
+    TEST_TRUE( p->car()->fixnum() == 1 );
+    TEST_TRUE( p->cdr().get() == s.get() );
+
+    p->set_car(uscheme::empty_list_value());
+    p->set_cdr(p);
+    TEST_TRUE( p->car()->is_empty_list() );
+    TEST_TRUE( p->cdr().get() == p.get() );
+}
+
+CPP_TEST( object_list )
+{
+    uscheme::object_ptr items[64];
+    for (int i = 0; i != 64; ++i) {
+        items[i] = uscheme::object::create_fixnum(i);
+    }
+
+    auto e = uscheme::object::create_list(items, 0, uscheme::empty_list_value());
+    TEST_TRUE( e->is_empty_list() );
+
+    auto l = uscheme::object::create_list(items, 64, uscheme::empty_list_value());
+    uscheme::object_ptr q = l;
+    for (int i = 0; i != 64; ++i) {
+        TEST_TRUE( q->is_pair() );
+        TEST_TRUE( q->car()->fixnum() == i );
+        /* the spine is one forward run of cells */
+        if (i != 63) {
+            TEST_TRUE( q->cdr().get() > q.get() );
+            TEST_TRUE( reinterpret_cast<const char*>(q->cdr().get())
+                       - reinterpret_cast<const char*>(q.get()) <= 32 );
+        }
+        q = q->cdr();
+    }
+    TEST_TRUE( q->is_empty_list() );
+
+    auto d = uscheme::object::create_list(items, 2, items[5]);
+    TEST_TRUE( d->cdr()->cdr()->fixnum() == 5 );
+}
+
+CPP_TEST( object_vector )
+{
+    auto v = uscheme::make_vector(10, uscheme::object::create_fixnum(7));
+    TEST_TRUE( v.is_heap() );
+    TEST_TRUE( v->type() == uscheme::VECTOR );
+    TEST_TRUE( v->is_vector() && !v->is_pair() );
+    TEST_TRUE( v->vector_length() == 10 );
+    for (size_t i = 0; i != 10; ++i) {
+        TEST_TRUE( uscheme::vector_ref(v, i)->fixnum() == 7 );
+    }
+
+    for (size_t i = 0; i != 10; ++i) {
+        uscheme::vector_set(v, i, uscheme::object::create_fixnum(long(i)));
+    }
+    uscheme::vector_fill(v, uscheme::true_value(), 2, 4);
+    TEST_TRUE( uscheme::vector_ref(v, 1)->fixnum() == 1 );
+    TEST_TRUE( uscheme::vector_ref(v, 2)->boolean() );
+    TEST_TRUE( uscheme::vector_ref(v, 3)->boolean() );
+    TEST_TRUE( uscheme::vector_ref(v, 4)->fixnum() == 4 );
+
+    /* overlapping copy within one vector */
+    uscheme::vector_copy(v, 5, v, 4, 9);
+    TEST_TRUE( uscheme::vector_ref(v, 5)->fixnum() == 4 );
+    TEST_TRUE( uscheme::vector_ref(v, 9)->fixnum() == 8 );
+
+    auto w = uscheme::make_vector(3, uscheme::empty_list_value());
+    uscheme::vector_copy(w, 1, v, 0, 2);
+    TEST_TRUE( w->vector_ref(0)->is_empty_list() );
+    TEST_TRUE( w->vector_ref(1)->fixnum() == 0 );
+    TEST_TRUE( w->vector_ref(2)->fixnum() == 1 );
+
+    TEST_TRUE( uscheme::make_vector(0, uscheme::true_value())->vector_length() == 0 );
+
+    try {
+        uscheme::vector_ref(v, 10);
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_VEC_RANGE );
+    }
+    try {
+        uscheme::vector_copy(w, 2, v, 0, 2);
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_VEC_RANGE );
+    }
+    try {
+        uscheme::vector_fill(uscheme::true_value(), v, 0, 0);
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_NOT_VEC );
+    }
+}
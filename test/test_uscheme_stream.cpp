@@ -3,12 +3,16 @@
  * \date 2015
  */
 
-
 // LANG includes
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 #include <exception>
 
 // TEST includes
@@ -17,6 +21,16 @@
 // PKG includes
 #include <uscheme/type/object.hpp>
 #include <uscheme/stream/stream.hpp>
+#include <uscheme/stream/file.hpp>
+#include <uscheme/stream/charclass.hpp>
+#include <uscheme/stream/scan.hpp>
+#include <uscheme/stream/parser.hpp>
+#include <uscheme/stream/parallel.hpp>
+#include <uscheme/stream/source.hpp>
+#include <uscheme/stream/literal.hpp>
+#include <uscheme/stream/fasl.hpp>
+#include <uscheme/exec/exec.hpp>
+#include <uscheme/gc/heap.hpp>
 
 CPP_TEST( read_object_fixnum )
 {
@@ -24,7 +38,7 @@ CPP_TEST( read_object_fixnum )
         std::stringstream strm;
         
         try {
-            auto p = uscheme::read_object(strm);
+            uscheme::read_object(strm);
         } catch (const std::exception& ex) {
             TEST_TRUE(
                 std::string(ex.what()).find("EOS") != std::string::npos);
@@ -34,9 +48,9 @@ CPP_TEST( read_object_fixnum )
     {
         std::stringstream strm;
         
-        strm << "127.";
+        strm << "127a";
         try {
-            auto p = uscheme::read_object(strm);
+            uscheme::read_object(strm);
         } catch (const std::exception& ex) {
             TEST_TRUE(
                 std::string(ex.what()).find("delimiter or whitespace")
@@ -136,7 +150,7 @@ CPP_TEST( read_object_boolean )
         strm << "#y";
         
         try {
-            auto p = uscheme::read_object(strm);
+            uscheme::read_object(strm);
         } catch (const std::exception& ex) {
             TEST_TRUE(
                 std::string(ex.what()).find("Invalid boolean") != std::string::npos);
@@ -554,3 +568,1176 @@ CPP_TEST( read_object_empty_list )
     }
 }
 
+CPP_TEST( read_object_symbol )
+{
+    {
+        std::stringstream strm;
+        strm << "foo list->vector + - ... <=? a.b@c";
+
+        const char* names[] = { "foo", "list->vector", "+", "-", "...", "<=?", "a.b@c" };
+        for (size_t i = 0; i != sizeof(names) / sizeof(names[0]); ++i) {
+            auto p = uscheme::read_object(strm);
+            TEST_TRUE( p->type() == uscheme::SYMBOL );
+            TEST_TRUE( p.bits() == uscheme::object::create_symbol(names[i]).bits() );
+
+            std::stringstream os;
+            uscheme::print_object(os, p);
+            TEST_TRUE( os.str() == names[i] );
+        }
+    }
+
+    {
+        std::stringstream strm;
+        strm << "+12 -3";
+        TEST_TRUE( uscheme::read_object(strm)->fixnum() == 12 );
+        TEST_TRUE( uscheme::read_object(strm)->fixnum() == -3 );
+    }
+
+    {
+        std::stringstream strm;
+        strm << "ab|c";
+
+        try {
+            uscheme::read_object(strm);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_INV_SYM );
+        }
+    }
+}
+
+CPP_TEST( read_object_list )
+{
+    {
+        std::stringstream strm;
+        strm << "(1 (two \"three\") () . #t)";
+
+        auto p = uscheme::read_object(strm);
+        TEST_TRUE( p->type() == uscheme::PAIR );
+        TEST_TRUE( p->car()->fixnum() == 1 );
+        TEST_TRUE( p->cdr()->car()->car()->is_symbol() );
+        TEST_TRUE( p->cdr()->car()->cdr()->car()->is_string() );
+        TEST_TRUE( p->cdr()->cdr()->car()->is_empty_list() );
+        TEST_TRUE( p->cdr()->cdr()->cdr()->boolean() );
+
+        std::stringstream os;
+        uscheme::print_object(os, p);
+        TEST_TRUE( os.str() == "(1 (two \"three\") () . #t)" );
+    }
+
+    {
+        std::stringstream strm;
+        strm << "( a\n ;comment\n b )(c)";
+
+        std::stringstream os;
+        uscheme::print_object(os, uscheme::read_object(strm));
+        uscheme::print_object(os, uscheme::read_object(strm));
+        TEST_TRUE( os.str() == "(a b)(c)" );
+    }
+
+    const char* bad[] = { "(1 2", "(1 . 2 3)", "(1 2)x", "(1 .", "((1 . " };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        std::stringstream strm;
+        strm << bad[i];
+
+        try {
+            uscheme::read_object(strm);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_TERM_LIST );
+        }
+    }
+
+    /* cut short after the dot is an error, not the end of input */
+    const std::string dotted = "(1 .";
+    const char* cur = dotted.data();
+    const uscheme::read_result result = uscheme::try_read_object(cur, dotted.data() + dotted.size());
+    TEST_TRUE( result.status == uscheme::READ_ERROR );
+    TEST_TRUE( result.error == uscheme::ERR_TERM_LIST );
+
+    /* a dot anywhere but before the tail of a list */
+    const char* dots[][2] = {
+        { "#(1 . 2)", "vector" },
+        { "( . 1)", "list" },
+        { "(1 . . 2)", "list" },
+        { ". ", "symbol" },
+    };
+    for (size_t i = 0; i != sizeof(dots) / sizeof(dots[0]); ++i) {
+        const std::string text = dots[i][0];
+        const std::string where = dots[i][1];
+        cur = text.data();
+        const uscheme::read_result r = uscheme::try_read_object(cur, text.data() + text.size());
+        TEST_TRUE( r.status == uscheme::READ_ERROR );
+        TEST_TRUE( r.error == ((where == "vector") ? uscheme::ERR_TERM_VEC :
+                               (where == "list") ? uscheme::ERR_TERM_LIST : uscheme::ERR_INV_SYM) );
+    }
+    const std::string dots_ok = "(... a .b)";
+    cur = dots_ok.data();
+    std::stringstream os;
+    uscheme::print_object(os, uscheme::read_object(cur, dots_ok.data() + dots_ok.size()));
+    TEST_TRUE( os.str() == "(... a .b)" );
+}
+
+CPP_TEST( read_object_vector )
+{
+    {
+        std::stringstream strm;
+        strm << "#(1 #(x) (a . b) \"s\" #t #\\a)";
+
+        auto p = uscheme::read_object(strm);
+        TEST_TRUE( p->type() == uscheme::VECTOR );
+        TEST_TRUE( p->vector_length() == 6 );
+        TEST_TRUE( p->vector_ref(0)->fixnum() == 1 );
+        TEST_TRUE( p->vector_ref(1)->is_vector() );
+        TEST_TRUE( p->vector_ref(2)->is_pair() );
+
+        std::stringstream os;
+        uscheme::print_object(os, p);
+        TEST_TRUE( os.str() == "#(1 #(x) (a . b) \"s\" #t #\\a)" );
+    }
+
+    {
+        std::stringstream strm;
+        strm << "#( )";
+
+        auto p = uscheme::read_object(strm);
+        TEST_TRUE( p->is_vector() && p->vector_length() == 0 );
+    }
+
+    const char* bad[] = { "#(1 2", "#(1)x" };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        std::stringstream strm;
+        strm << bad[i];
+
+        try {
+            uscheme::read_object(strm);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_TERM_VEC );
+        }
+    }
+}
+
+CPP_TEST( read_object_flonum )
+{
+    const char* good[] = { "127.", "-0.5", "+.25", ".5", "1e3", "6.02e23",
+                           "1.7976931348623157e308", "4.9e-324", "-0.0" };
+    const double values[] = { 127.0, -0.5, 0.25, 0.5, 1000.0, 6.02e23,
+                              1.7976931348623157e308, 4.9e-324, -0.0 };
+    for (size_t i = 0; i != sizeof(good) / sizeof(good[0]); ++i) {
+        std::stringstream strm;
+        strm << good[i];
+
+        auto p = uscheme::read_object(strm);
+        TEST_TRUE( p->type() == uscheme::FLONUM );
+        TEST_TRUE( p->flonum() == values[i] );
+
+        /* printing reads back to the same value */
+        std::stringstream os;
+        uscheme::print_object(os, p);
+        auto q = uscheme::read_object(os);
+        TEST_TRUE( q->is_flonum() && q->flonum() == values[i] );
+    }
+
+    {
+        std::stringstream strm;
+        strm << "(+inf.0 -inf.0 +nan.0 . 1.5)";
+
+        auto p = uscheme::read_object(strm);
+        TEST_TRUE( p->car()->is_flonum() && p->car()->flonum() > 1e308 );
+        TEST_TRUE( p->cdr()->car()->flonum() < -1e308 );
+        TEST_TRUE( p->cdr()->cdr()->car()->flonum() !=
+                   p->cdr()->cdr()->car()->flonum() );
+
+        std::stringstream os;
+        uscheme::print_object(os, p);
+        TEST_TRUE( os.str() == "(+inf.0 -inf.0 +nan.0 . 1.5)" );
+    }
+
+    {
+        std::stringstream strm;
+        strm << "(+ - ... +i)";
+
+        auto p = uscheme::read_object(strm);
+        TEST_TRUE( p->car()->is_symbol() );
+        TEST_TRUE( p->cdr()->cdr()->car()->is_symbol() );
+    }
+
+    const char* bad[] = { "1.2.3", "1e", "-.", "1e+", "2.5x" };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        std::stringstream strm;
+        strm << bad[i];
+
+        try {
+            uscheme::read_object(strm);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_TERM_NUM );
+        }
+    }
+}
+
+CPP_TEST( read_object_span )
+{
+    const std::string text = "(a b) 12 \"str\" #(1 2.5) ; note\n sym";
+    const char* cur = text.data();
+    const char* const end = text.data() + text.size();
+
+    auto p = uscheme::read_object(cur, end);
+    TEST_TRUE( p->is_pair() );
+    TEST_TRUE( uscheme::read_object(cur, end)->fixnum() == 12 );
+    TEST_TRUE( uscheme::read_object(cur, end)->string_length() == 3 );
+    TEST_TRUE( uscheme::read_object(cur, end)->is_vector() );
+    auto s = uscheme::read_object(cur, end);
+    TEST_TRUE( s->is_symbol() && s->symbol_length() == 3 );
+    TEST_TRUE( cur == end );
+
+    try {
+        uscheme::read_object(cur, end);
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_EOS );
+    }
+}
+
+CPP_TEST( read_object_deep_nesting )
+{
+    /* far deeper than the C stack would allow a recursive reader */
+    const size_t depth = 200000;
+    {
+        const std::string text = std::string(depth, '(') + "x" + std::string(depth, ')');
+        const char* cur = text.data();
+        auto p = uscheme::read_object(cur, text.data() + text.size());
+        size_t n = 0;
+        for (; p->is_pair(); p = p->car()) {
+            TEST_TRUE( p->cdr()->is_empty_list() );
+            ++n;
+        }
+        TEST_TRUE( (n == depth) && p->is_symbol() );
+    }
+    {
+        std::string text;
+        for (size_t i = 0; i != depth; ++i) {
+            text += "(a . ";
+        }
+        text += "b" + std::string(depth, ')') + " 7";
+        std::stringstream strm(text);
+        auto p = uscheme::read_object(strm);
+        size_t n = 0;
+        for (; p->is_pair(); p = p->cdr()) {
+            TEST_TRUE( p->car()->is_symbol() );
+            ++n;
+        }
+        TEST_TRUE( (n == depth) && p->is_symbol() );
+        TEST_TRUE( uscheme::read_object(strm)->fixnum() == 7 );
+    }
+    {
+        std::string text;
+        for (size_t i = 0; i != depth; ++i) {
+            text += "#(1 ";
+        }
+        text += std::string(depth, ')');
+        const char* cur = text.data();
+        auto v = uscheme::read_object(cur, text.data() + text.size());
+        size_t n = 0;
+        for (; v->vector_length() == 2; v = v->vector_ref(1)) {
+            TEST_TRUE( v->vector_ref(0)->fixnum() == 1 );
+            ++n;
+        }
+        TEST_TRUE( (n == depth - 1) && (v->vector_length() == 1) );
+    }
+    {
+        /* an error deep inside leaves the reader usable */
+        const std::string text = std::string(depth, '(') + " #q";
+        const char* cur = text.data();
+        try {
+            uscheme::read_object(cur, text.data() + text.size());
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_INV_BOOL );
+        }
+        const std::string ok = "(1 (2) . 3)";
+        cur = ok.data();
+        std::stringstream os;
+        uscheme::print_object(os, uscheme::read_object(cur, ok.data() + ok.size()));
+        TEST_TRUE( os.str() == ok );
+    }
+    uscheme::collect_garbage();
+}
+
+CPP_TEST( print_object_deep_nesting )
+{
+    /* far deeper than the C stack would allow a recursive printer */
+    const size_t depth = 200000;
+    const std::string texts[] = {
+        std::string(depth, '(') + std::string(depth, ')'),
+        std::string(depth, '(') + "x" + std::string(depth, ')'),
+        "(a " + std::string(depth, '(') + std::string(depth, ')') + " . b)",
+    };
+    for (const std::string& text : texts) {
+        const char* cur = text.data();
+        std::stringstream os;
+        uscheme::print_object(os, uscheme::read_object(cur, text.data() + text.size()));
+        TEST_TRUE( os.str() == text );
+    }
+
+    std::string vectors;
+    for (size_t i = 0; i != depth; ++i) {
+        vectors += "#(1 ";
+    }
+    vectors += "#()" + std::string(depth, ')');
+    const char* cur = vectors.data();
+    std::stringstream os;
+    uscheme::print_object(os, uscheme::read_object(cur, vectors.data() + vectors.size()));
+    TEST_TRUE( os.str() == vectors );
+    uscheme::collect_garbage();
+}
+
+CPP_TEST( print_object_cycles )
+{
+    const std::string text = "(1 2 3)";
+    const char* cur = text.data();
+    uscheme::object_ptr p = uscheme::read_object(cur, text.data() + text.size());
+    uscheme::gc_root r(p);
+
+    /* shared but acyclic structure is printed in full */
+    uscheme::object_ptr shared = uscheme::object::create_pair(p, p);
+    std::stringstream os;
+    uscheme::print_object(os, shared);
+    TEST_TRUE( os.str() == "((1 2 3) 1 2 3)" );
+
+    p->cdr()->cdr()->set_cdr(p);
+    os.str("");
+    uscheme::print_object(os, p);
+    TEST_TRUE( os.str() == "#0=(1 2 3 . #0#)" );
+
+    p->set_car(p);
+    os.str("");
+    uscheme::print_object(os, p);
+    TEST_TRUE( os.str() == "#0=(#0# 2 3 . #0#)" );
+
+    uscheme::object_ptr v = uscheme::object::create_vector(2, p);
+    v->vector_set(1, v);
+    os.str("");
+    uscheme::print_object(os, v);
+    TEST_TRUE( os.str() == "#0=#(#1=(#1# 2 3 . #1#) #0#)" );
+
+    /* a cycle through the tail of a list after its first pair */
+    p->set_car(uscheme::object::create_fixnum(1));
+    p->cdr()->cdr()->set_cdr(p->cdr());
+    os.str("");
+    uscheme::print_object(os, p);
+    TEST_TRUE( os.str() == "(1 . #0=(2 3 . #0#))" );
+}
+
+CPP_TEST( read_object_stream_leftover )
+{
+    /* what the reader does not consume is left in the stream */
+    std::stringstream strm;
+    strm << "(a b) 12 rest of line";
+
+    TEST_TRUE( uscheme::read_object(strm)->is_pair() );
+    TEST_TRUE( uscheme::read_object(strm)->fixnum() == 12 );
+    std::string rest;
+    std::getline(strm, rest);
+    TEST_TRUE( rest == " rest of line" );
+}
+
+/* hands out a string a few bytes at a time */
+class trickle_buf : public std::streambuf
+{
+  public:
+    trickle_buf(const std::string& text, size_t step) : text_(text), pos_(0), step_(step) {}
+
+  protected:
+    int_type underflow()
+    {
+        if (pos_ == text_.size()) {
+            return traits_type::eof();
+        }
+        char* base = &text_[0];
+        const size_t n = std::min(step_, text_.size() - pos_);
+        setg(base, base + pos_, base + pos_ + n);
+        pos_ += n;
+        return traits_type::to_int_type(*gptr());
+    }
+
+  private:
+    std::string text_;
+    size_t      pos_;
+    size_t      step_;
+};
+
+CPP_TEST( read_object_stream_refill )
+{
+    /* tokens straddle every refill */
+    std::string text = "(";
+    for (int i = 0; i != 500; ++i) {
+        text += "symbol-" + std::to_string(i) + " \"a string " + std::to_string(i) +
+                "\" " + std::to_string(i * 1000003) + " " + std::to_string(i) + ".25 #\\space ";
+    }
+    text += ") tail";
+
+    for (size_t step = 1; step < 12; step += 3) {
+        trickle_buf buf(text, step);
+        std::istream strm(&buf);
+
+        auto p = uscheme::read_object(strm);
+        for (int i = 0; i != 500; ++i) {
+            const std::string name = "symbol-" + std::to_string(i);
+            TEST_TRUE( p->car()->symbol_length() == name.size() );
+            TEST_TRUE( std::string(p->car()->symbol_name(), name.size()) == name );
+            p = p->cdr();
+            TEST_TRUE( std::string(p->car()->string(), p->car()->string_length()) ==
+                       "a string " + std::to_string(i) );
+            p = p->cdr();
+            TEST_TRUE( p->car()->fixnum() == i * 1000003 );
+            p = p->cdr();
+            TEST_TRUE( p->car()->flonum() == i + 0.25 );
+            p = p->cdr();
+            TEST_TRUE( p->car()->character() == ' ' );
+            p = p->cdr();
+        }
+        TEST_TRUE( p->is_empty_list() );
+
+        auto tail = uscheme::read_object(strm);
+        TEST_TRUE( tail->is_symbol() && tail->symbol_length() == 4 );
+        try {
+            uscheme::read_object(strm);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_EOS );
+        }
+    }
+}
+
+CPP_TEST( read_file_mapped )
+{
+    {
+        std::ofstream out("read_file.scm", std::ios::binary);
+        out << "; config\n(name \"a fairly long string value\") 42\n#(1 2.5) last";
+    }
+
+    auto forms = uscheme::read_file("read_file.scm");
+    TEST_TRUE( forms->is_pair() );
+    auto first = forms->car();
+    TEST_TRUE( first->is_pair() && first->cdr()->car()->string_length() == 26 );
+    TEST_TRUE( std::string(first->cdr()->car()->string()) == "a fairly long string value" );
+    TEST_TRUE( forms->cdr()->car()->fixnum() == 42 );
+    TEST_TRUE( forms->cdr()->cdr()->car()->is_vector() );
+    TEST_TRUE( forms->cdr()->cdr()->cdr()->cdr()->is_empty_list() );
+
+    auto last = uscheme::load_file("read_file.scm");
+    TEST_TRUE( last->is_symbol() && last->symbol_length() == 4 );
+
+    {
+        std::ofstream out("read_file.scm", std::ios::binary | std::ios::trunc);
+    }
+    TEST_TRUE( uscheme::read_file("read_file.scm")->is_empty_list() );
+    TEST_TRUE( uscheme::load_file("read_file.scm")->is_empty_list() );
+    remove("read_file.scm");
+
+    const char* bad[] = { "read_file_missing.scm", "." };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        try {
+            uscheme::read_file(bad[i]);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_FILE_OPEN );
+        }
+    }
+}
+
+CPP_TEST( scan_levels_agree )
+{
+    /* every level finds the same byte, for every start and length */
+    const char alphabet[] = { ' ', '\t', '\n', '\r', '\v', '\f', 'a', '"', '\\',
+                              '\0', ';', '(', '\x80', '\xff', '\x08', '\x0e' };
+    std::string text(300, ' ');
+    unsigned seed = 7;
+    for (size_t i = 0; i != text.size(); ++i) {
+        seed = seed * 1103515245u + 12345u;
+        /* long runs of one class with the odd other byte */
+        text[i] = ((seed >> 16) % 8) ? text[(i > 0) ? i - 1 : 0]
+                                     : alphabet[(seed >> 20) % sizeof(alphabet)];
+    }
+
+    const uscheme::scan_level widest = uscheme::set_scan_level(uscheme::SCAN_AVX2);
+    for (int level = uscheme::SCAN_SCALAR; level <= widest; ++level) {
+        TEST_TRUE( uscheme::set_scan_level(static_cast<uscheme::scan_level>(level)) == level );
+        for (size_t b = 0; b != 70; ++b) {
+            for (size_t e = b; e <= text.size(); e += 7) {
+                const char* begin = text.data() + b;
+                const char* end = text.data() + e;
+
+                const char* p = begin;
+                while ((p != end) && isspace(static_cast<unsigned char>(*p))) { ++p; }
+                TEST_TRUE( uscheme::scan_space(begin, end) == p );
+
+                p = begin;
+                while ((p != end) && (*p != '\n') && (*p != '\r')) { ++p; }
+                TEST_TRUE( uscheme::scan_line(begin, end) == p );
+
+                p = begin;
+                while ((p != end) && (*p != '"') && (*p != '\\') && (*p != '\0')) { ++p; }
+                TEST_TRUE( uscheme::scan_string(begin, end) == p );
+            }
+        }
+    }
+    uscheme::set_scan_level(widest);
+
+    /* escapes between long runs */
+    std::string body(100, 'x');
+    std::stringstream strm;
+    strm << "\"" << body << "\\n" << body << "\\q\\\"" << body << "\" ; " << body << "\n  " << body;
+    auto p = uscheme::read_object(strm);
+    TEST_TRUE( p->string_length() == 3 * body.size() + 3 );
+    TEST_TRUE( std::string(p->string(), p->string_length()) ==
+               body + "\n" + body + "q\"" + body );
+    TEST_TRUE( uscheme::read_object(strm)->symbol_length() == body.size() );
+}
+
+CPP_TEST( char_class_table )
+{
+    /* ASCII agrees with <cctype> in the C locale; other bytes have no class */
+    for (int c = 0; c != 256; ++c) {
+        const char ch = static_cast<char>(c);
+        const bool ascii = (c < 128);
+        TEST_TRUE( uscheme::char_is(ch, uscheme::CHAR_SPACE) == (ascii && isspace(c)) );
+        TEST_TRUE( uscheme::char_is(ch, uscheme::CHAR_DIGIT) == (ascii && isdigit(c)) );
+        TEST_TRUE( uscheme::char_is(ch, uscheme::CHAR_DELIMITER) ==
+                   ((ascii && isspace(c)) || (c == 0xff) || ((c != 0) && strchr("()\";", c))) );
+        const bool initial = ascii && (isalpha(c) || ((c != 0) && strchr("!$%&*/:<=>?^_~", c)));
+        TEST_TRUE( uscheme::char_is(ch, uscheme::CHAR_INITIAL) == initial );
+        TEST_TRUE( uscheme::char_is(ch, uscheme::CHAR_SUBSEQUENT) ==
+                   (initial || (ascii && isdigit(c)) || ((c != 0) && strchr("+-.@", c))) );
+    }
+
+    /* a Latin-1 letter is not an identifier character whatever the locale */
+    std::stringstream strm;
+    strm << "abc\xe9";
+    try {
+        uscheme::read_object(strm);
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_INV_SYM );
+    }
+}
+
+static std::string to_text(const uscheme::object_ptr& p)
+{
+    std::stringstream os;
+    uscheme::print_object(os, p);
+    return os.str();
+}
+
+CPP_TEST( parser_push_chunks )
+{
+    const std::string text =
+        "  ; leading comment (with a paren\n"
+        "(define (f x) \"a (string) with \\\"escapes\\\" ;not a comment\")\n"
+        "#(1 #\\( #\\) #\\; #\\\" #\\space) ; trailing (\n"
+        "(a . b) 42 -1.5e3 #t sym \"\" 123456789012345678901234567890 last";
+
+    /* the objects the reader finds in the whole text */
+    std::vector<std::string> expected;
+    const char* cur = text.data();
+    const char* const end = text.data() + text.size();
+    while (true) {
+        try {
+            expected.push_back(to_text(uscheme::read_object(cur, end)));
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_EOS );
+            break;
+        }
+    }
+    TEST_TRUE( expected.size() == 10 );
+
+    /* the same objects for any chunking of the input */
+    for (size_t chunk = 1; chunk <= text.size(); chunk += (chunk < 16) ? 1 : 29) {
+        uscheme::parser parser;
+        std::vector<std::string> got;
+        uscheme::object_ptr p;
+        for (size_t pos = 0; pos < text.size(); pos += chunk) {
+            parser.feed(text.data() + pos, std::min(chunk, text.size() - pos));
+            while (parser.next(p) == uscheme::PARSE_OBJECT) {
+                got.push_back(to_text(p));
+            }
+        }
+        /* the last atom needs the end of input to end */
+        TEST_TRUE( got.size() == expected.size() - 1 );
+        parser.finish();
+        TEST_TRUE( parser.next(p) == uscheme::PARSE_OBJECT );
+        got.push_back(to_text(p));
+        TEST_TRUE( parser.next(p) == uscheme::PARSE_END );
+        TEST_TRUE( got == expected );
+    }
+}
+
+CPP_TEST( parser_push_errors )
+{
+    uscheme::parser parser;
+    uscheme::object_ptr p;
+
+    parser.feed("(a b", 4);
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_MORE );
+    parser.feed(") (c)", 5);
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_OBJECT );
+    TEST_TRUE( to_text(p) == "(a b)" );
+    /* the closing paren may still be followed by junk */
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_MORE );
+
+    /* a bad object is dropped and parsing goes on after it */
+    parser.feed(" ) 7 \"open", 10);
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_OBJECT );
+    TEST_TRUE( to_text(p) == "(c)" );
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_ERROR );
+    TEST_TRUE( parser.error() == uscheme::ERR_UNK_TYPE );
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_OBJECT );
+    TEST_TRUE( p->fixnum() == 7 );
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_MORE );
+
+    /* input that ends inside an object is reported at finish */
+    parser.finish();
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_ERROR );
+    TEST_TRUE( parser.error() == uscheme::ERR_STR_ABR );
+    TEST_TRUE( parser.next(p) == uscheme::PARSE_END );
+}
+
+/* many top level data with the structure the splitter has to respect */
+static std::string many_data(size_t count)
+{
+    std::string text;
+    for (size_t i = 0; i != count; ++i) {
+        const std::string n = std::to_string(i);
+        switch (i % 5) {
+            case 0: text += "(define (f" + n + " x) \"a (string) \\\" ;" + n + "\")\n"; break;
+            case 1: text += "; comment ( \" \n#(" + n + " #\\( #\\) #\\\" 2.5)\n"; break;
+            case 2: text += "(a (b (c . " + n + "))) sym" + n + " "; break;
+            case 3: text += "#\\space \"\" " + n + "12345678901234567890\t"; break;
+            default: text += "((#t #f) (-1.5e3 #\\;))\r\n"; break;
+        }
+    }
+    return text;
+}
+
+CPP_TEST( read_objects_parallel )
+{
+    const std::string text = many_data(20000);
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+
+    const std::string expected = to_text(uscheme::read_objects(begin, end, 1));
+    for (unsigned threads = 2; threads <= 8; threads *= 2) {
+        TEST_TRUE( to_text(uscheme::read_objects(begin, end, threads)) == expected );
+    }
+    TEST_TRUE( to_text(uscheme::read_objects(begin, end, 0)) == expected );
+
+    /* the cells the threads made are ordinary heap cells afterwards */
+    uscheme::object_ptr forms = uscheme::read_objects(begin, end, 4);
+    uscheme::gc_root guard(forms);
+    uscheme::collect_garbage();
+    TEST_TRUE( to_text(forms) == expected );
+    forms = uscheme::empty_list_value();
+    uscheme::collect_garbage();
+
+    TEST_TRUE( uscheme::read_objects(begin, begin, 4)->is_empty_list() );
+
+    /* one top level datum cannot be split */
+    const std::string one = "(" + text + ")";
+    const char* const one_end = one.data() + one.size();
+    const std::string one_expected = to_text(uscheme::read_objects(one.data(), one_end, 1));
+    TEST_TRUE( to_text(uscheme::read_objects(one.data(), one_end, 4)) == one_expected );
+}
+
+CPP_TEST( read_objects_parallel_errors )
+{
+    /* the first error in input order wins, wherever the pieces fall */
+    std::string text = many_data(20000);
+    text.insert(text.find('\n', text.size() / 3) + 1, " #q ");
+    text.insert(text.find('\n', 2 * text.size() / 3) + 1, " #\\nope ");
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        try {
+            uscheme::read_objects(text.data(), text.data() + text.size(), threads);
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            TEST_TRUE( ex.id() == uscheme::ERR_INV_BOOL );
+        }
+    }
+}
+
+CPP_TEST( reader_fold_case )
+{
+    uscheme::reader_options options;
+    TEST_TRUE( !options.fold_case );
+    options.fold_case = true;
+    uscheme::reader folding(options);
+    uscheme::reader plain;
+    TEST_TRUE( folding.options().fold_case && !plain.options().fold_case );
+
+    const std::string text = "(Define X #T #F #\\Space #\\NEWLINE #\\A \"Str\" +INF.0 lower)";
+    const char* cur = text.data();
+    TEST_TRUE( to_text(folding.read(cur, text.data() + text.size())) ==
+               "(define x #t #f #\\space #\\newline #\\A \"Str\" +inf.0 lower)" );
+
+    /* the same symbol whichever case it was written in */
+    std::stringstream strm("FOO foo");
+    TEST_TRUE( folding.read(strm).get() == folding.read(strm).get() );
+
+    cur = text.data();
+    try {
+        plain.read(cur, text.data() + text.size());
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_INV_BOOL );
+    }
+    const std::string symbols = "(Define x)";
+    cur = symbols.data();
+    TEST_TRUE( to_text(plain.read(cur, symbols.data() + symbols.size())) == symbols );
+}
+
+CPP_TEST( reader_threads )
+{
+    /* readers on different threads share nothing but the symbol table */
+    const std::string text = many_data(4000);
+    const char* const end = text.data() + text.size();
+    std::string expected;
+    {
+        uscheme::reader r;
+        const char* cur = text.data();
+        for (int i = 0; i != 100; ++i) {
+            expected += to_text(r.read(cur, end));
+        }
+    }
+
+    std::vector<std::string> got(4);
+    {
+        uscheme::gc_parallel_scope closed;
+        std::vector<uscheme::gc_arena> arenas(got.size());
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t != got.size(); ++t) {
+            threads.emplace_back([&, t] {
+                uscheme::gc_arena_scope scope(arenas[t]);
+                uscheme::reader r;
+                const char* cur = text.data();
+                for (int i = 0; i != 100; ++i) {
+                    got[t] += to_text(r.read(cur, end));
+                }
+            });
+        }
+        for (size_t t = 0; t != threads.size(); ++t) {
+            threads[t].join();
+        }
+    }
+    for (size_t t = 0; t != got.size(); ++t) {
+        TEST_TRUE( got[t] == expected );
+    }
+}
+
+CPP_TEST( try_read_object_status )
+{
+    {
+        const std::string text = "  (a b) ; done\n";
+        const char* cur = text.data();
+        const char* const end = cur + text.size();
+        uscheme::read_result result = uscheme::try_read_object(cur, end);
+        TEST_TRUE( (result.status == uscheme::READ_OBJECT) && result.object->is_pair() );
+        result = uscheme::try_read_object(cur, end);
+        TEST_TRUE( (result.status == uscheme::READ_EOS) && (result.error == uscheme::ERR_EOS) );
+    }
+
+    /* the same error as the throwing reader, and nothing consumed */
+    const char* bad[] = { "#y", "#\\nx", "\"abc", "\"a\"b", "1.2.3", "(a . b c)",
+                          "(1 2", "#(1 2", "(", ")", "sym|", "(a (b #q))", "(a . " };
+    for (size_t i = 0; i != sizeof(bad) / sizeof(bad[0]); ++i) {
+        const std::string text = bad[i];
+        uscheme::except_id thrown = uscheme::ERR_EOS;
+        try {
+            const char* cur = text.data();
+            uscheme::read_object(cur, text.data() + text.size());
+            TEST_TRUE( false );
+        } catch (const uscheme::exception& ex) {
+            thrown = ex.id();
+        }
+        const char* cur = text.data();
+        const uscheme::read_result result =
+            uscheme::try_read_object(cur, text.data() + text.size());
+        TEST_TRUE( result.status == ((thrown == uscheme::ERR_EOS) ? uscheme::READ_EOS
+                                                                   : uscheme::READ_ERROR) );
+        TEST_TRUE( result.error == thrown );
+        TEST_TRUE( cur == text.data() );
+    }
+
+    {
+        std::stringstream strm("#q 12");
+        TEST_TRUE( uscheme::try_read_object(strm).status == uscheme::READ_ERROR );
+        std::stringstream rest("12 ");
+        uscheme::read_result result = uscheme::try_read_object(rest);
+        TEST_TRUE( (result.status == uscheme::READ_OBJECT) && (result.object->fixnum() == 12) );
+        result = uscheme::try_read_object(rest);
+        TEST_TRUE( result.status == uscheme::READ_EOS );
+        result = uscheme::try_read_object(rest);
+        TEST_TRUE( result.status == uscheme::READ_EOS );
+    }
+}
+
+static std::string span_text(const uscheme::source_map& sources, const uscheme::object_ptr& p)
+{
+    uscheme::source_span span;
+    if (!sources.find(p, span)) {
+        return "none";
+    }
+    return std::to_string(span.line) + ":" + std::to_string(span.column) + "-" +
+           std::to_string(span.end_line) + ":" + std::to_string(span.end_column);
+}
+
+CPP_TEST( source_map_spans )
+{
+    const std::string text =
+        "; header\n"
+        "(define (f x)\n"
+        "  \"str\")\n"
+        "  #(1 2.5) 42 sym\n"
+        "(a . (b))";
+
+    for (size_t step = 0; step != 4; ++step) {
+        uscheme::source_map sources("spans.scm");
+        uscheme::reader_options options;
+        options.sources = &sources;
+        uscheme::reader r(options);
+
+        std::vector<uscheme::object_ptr> forms;
+        if (step == 0) {
+            const char* cur = text.data();
+            const char* const end = cur + text.size();
+            for (uscheme::read_result res; (res = r.try_read(cur, end)).status == uscheme::READ_OBJECT; ) {
+                forms.push_back(res.object);
+            }
+        } else {
+            /* the stream window is refilled and moved every few bytes */
+            trickle_buf buf(text, step * 2 - 1);
+            std::istream strm(&buf);
+            for (uscheme::read_result res; (res = r.try_read(strm)).status == uscheme::READ_OBJECT; ) {
+                forms.push_back(res.object);
+            }
+        }
+        TEST_TRUE( forms.size() == 5 );
+        TEST_TRUE( std::string(sources.name()) == "spans.scm" );
+
+        const uscheme::object_ptr define = forms[0];
+        TEST_TRUE( span_text(sources, define) == "2:1-3:9" );
+        TEST_TRUE( span_text(sources, define->cdr()->car()) == "2:9-2:14" );
+        TEST_TRUE( span_text(sources, define->cdr()->cdr()->car()) == "3:3-3:8" );
+        TEST_TRUE( span_text(sources, forms[1]) == "4:3-4:11" );
+        TEST_TRUE( span_text(sources, forms[1]->vector_ref(1)) == "4:7-4:10" );
+        TEST_TRUE( span_text(sources, forms[2]) == "none" ); /* a fixnum */
+        TEST_TRUE( span_text(sources, forms[3]) == "none" ); /* a symbol */
+        TEST_TRUE( span_text(sources, forms[4]) == "5:1-5:10" );
+        TEST_TRUE( span_text(sources, forms[4]->cdr()) == "5:6-5:9" );
+        TEST_TRUE( sources.size() == 7 );
+
+        /* found at their new addresses once collected */
+        uscheme::object_ptr kept = define;
+        uscheme::gc_root guard(kept);
+        forms.clear();
+        uscheme::collect_garbage();
+        TEST_TRUE( span_text(sources, kept) == "2:1-3:9" );
+        TEST_TRUE( span_text(sources, kept->cdr()->cdr()->car()) == "3:3-3:8" );
+    }
+}
+
+CPP_TEST( source_map_errors )
+{
+    /* a datum that fails leaves no entries, and positions go on after it */
+    uscheme::source_map sources("errors.scm");
+    uscheme::reader_options options;
+    options.sources = &sources;
+    uscheme::reader r(options);
+
+    std::string text;
+    for (int i = 0; i != 100; ++i) {
+        text += "(\"s\" (x))\n";
+    }
+    const std::string bad = "(\"a\" (b) #q)";
+    const char* cur = text.data();
+    const char* const end = cur + text.size();
+    for (int i = 0; i != 100; ++i) {
+        TEST_TRUE( r.try_read(cur, end).status == uscheme::READ_OBJECT );
+        const char* b = bad.data();
+        TEST_TRUE( r.try_read(b, bad.data() + bad.size()).status == uscheme::READ_ERROR );
+        TEST_TRUE( sources.size() == 3 * static_cast<size_t>(i + 1) );
+    }
+
+    /* the last newline of text was never read */
+    const std::string tail = "\n (\"t\")";
+    cur = tail.data();
+    uscheme::object_ptr p = r.read(cur, tail.data() + tail.size());
+    TEST_TRUE( span_text(sources, p) == "101:2-101:7" );
+    TEST_TRUE( span_text(sources, p->car()) == "101:3-101:6" );
+
+    /* cleared data are forgotten, and lines go on counting */
+    sources.clear();
+    TEST_TRUE( sources.size() == 0 );
+    TEST_TRUE( span_text(sources, p) == "none" );
+    const std::string more = " (u)\n\n  #(v)";
+    cur = more.data();
+    uscheme::object_ptr q = r.read(cur, more.data() + more.size());
+    TEST_TRUE( span_text(sources, q) == "101:8-101:11" );
+    q = r.read(cur, more.data() + more.size());
+    TEST_TRUE( span_text(sources, q) == "103:3-103:7" );
+    TEST_TRUE( sources.size() == 2 );
+}
+
+CPP_TEST( literal_table_sharing )
+{
+    uscheme::literal_table literals;
+    uscheme::reader_options options;
+    options.literals = &literals;
+    uscheme::reader r(options);
+
+    const std::string text =
+        "(\"ab\" \"a long string that is not stored inline\" \"tab\\there\" 1.5 -inf.0 "
+        "123456789012345678901234567890 sym 7)\n"
+        "(\"ab\" \"a long string that is not stored inline\" \"tab\\there\" 1.5 -inf.0 "
+        "123456789012345678901234567890 sym 7)\n"
+        "(\"ac\" 2.5 -123456789012345678901234567890)";
+    const char* cur = text.data();
+    const char* const end = cur + text.size();
+    uscheme::object_ptr first = r.read(cur, end);
+    uscheme::gc_root first_root(first);
+    uscheme::object_ptr second = r.read(cur, end);
+    uscheme::gc_root second_root(second);
+    uscheme::object_ptr third = r.read(cur, end);
+    uscheme::gc_root third_root(third);
+    TEST_TRUE( literals.size() == 9 );
+    TEST_TRUE( literals.hits() == 6 );
+
+    /* everything survives a collection, still shared */
+    uscheme::collect_garbage();
+    uscheme::object_ptr a = first;
+    uscheme::object_ptr b = second;
+    for (int i = 0; i != 6; ++i) {
+        TEST_TRUE( a->car().is_heap() );
+        TEST_TRUE( a->car().get() == b->car().get() );
+        a = a->cdr();
+        b = b->cdr();
+    }
+    TEST_TRUE( std::string(first->cdr()->cdr()->car()->string()) == "tab\there" );
+    TEST_TRUE( first->car().get() != third->car().get() );
+    TEST_TRUE( first->cdr()->cdr()->cdr()->car().get() != third->cdr()->car().get() );
+    TEST_TRUE( third->cdr()->cdr()->car()->bignum_negative() );
+
+    /* the table keeps handing out the same objects */
+    TEST_TRUE( literals.string("ab", 2).get() == first->car().get() );
+    TEST_TRUE( literals.flonum(1.5).get() == first->cdr()->cdr()->cdr()->car().get() );
+    TEST_TRUE( literals.size() == 9 );
+
+    /* a reader without the table makes new objects */
+    cur = text.data();
+    uscheme::object_ptr fresh = uscheme::read_object(cur, end);
+    TEST_TRUE( fresh->car().get() != first->car().get() );
+}
+
+/* every datum of text, in order */
+static std::vector<uscheme::object_ptr> read_all(const std::string& text)
+{
+    std::vector<uscheme::object_ptr> data;
+    const char* cur = text.data();
+    const char* const end = cur + text.size();
+    uscheme::read_result result;
+    while ((result = uscheme::try_read_object(cur, end)).status == uscheme::READ_OBJECT) {
+        data.push_back(result.object);
+    }
+    return data;
+}
+
+CPP_TEST( fasl_round_trip )
+{
+    const std::string text = many_data(1000) +
+        " -98765432109876543210987654321 +inf.0 -inf.0 0.0 -0.0 #\\x #\\newline \"\" #()"
+        " 4611686018427387903 -4611686018427387904 (1 . 2) #(#(#()) (()))";
+    const std::vector<uscheme::object_ptr> data = read_all(text);
+    TEST_TRUE( data.size() > 1000 );
+
+    std::stringstream out;
+    {
+        uscheme::fasl_writer w(out);
+        for (size_t i = 0; i != data.size(); ++i) {
+            w.write(data[i]);
+        }
+    }
+    const std::string fasl = out.str();
+
+    /* in place and from a stream, each datum prints as it did */
+    uscheme::fasl_reader in_place(fasl.data(), fasl.data() + fasl.size());
+    std::stringstream in(fasl);
+    uscheme::fasl_reader streamed(in);
+    for (size_t i = 0; i != data.size(); ++i) {
+        const std::string expected = to_text(data[i]);
+        TEST_TRUE( to_text(in_place.read()) == expected );
+        TEST_TRUE( to_text(streamed.read()) == expected );
+    }
+    TEST_TRUE( in_place.try_read().status == uscheme::READ_EOS );
+    TEST_TRUE( streamed.try_read().status == uscheme::READ_EOS );
+
+    /* the string and symbol tables keep the binary form smaller */
+    TEST_TRUE( fasl.size() < text.size() );
+}
+
+CPP_TEST( fasl_shared_structure )
+{
+    const std::string text = "(\"s\" \"s\" #(1 2) 3.5 123456789012345678901234567890)";
+    const char* cur = text.data();
+    uscheme::object_ptr p = uscheme::read_object(cur, text.data() + text.size());
+
+    /* (s s' v v f f b b . p) with s shared, a cycle back to the start,
+       and a string equal to s but not eq */
+    uscheme::object_ptr s = p->car();
+    uscheme::object_ptr v = p->cdr()->cdr()->car();
+    uscheme::object_ptr f = p->cdr()->cdr()->cdr()->car();
+    uscheme::object_ptr b = p->cdr()->cdr()->cdr()->cdr()->car();
+    uscheme::object_ptr list = p;
+    list = uscheme::object::create_pair(b, list);
+    list = uscheme::object::create_pair(b, list);
+    list = uscheme::object::create_pair(f, list);
+    list = uscheme::object::create_pair(f, list);
+    list = uscheme::object::create_pair(v, list);
+    list = uscheme::object::create_pair(v, list);
+    list = uscheme::object::create_pair(p->cdr()->car(), list);
+    list = uscheme::object::create_pair(s, list);
+    p->cdr()->cdr()->cdr()->cdr()->set_cdr(list);
+    v->vector_set(1, v);
+
+    /* far deeper than the C stack would allow a recursive writer */
+    const size_t depth = 200000;
+    uscheme::object_ptr deep = uscheme::empty_list_value();
+    for (size_t i = 0; i != depth; ++i) {
+        deep = uscheme::object::create_pair(deep, uscheme::empty_list_value());
+    }
+
+    std::stringstream out;
+    {
+        uscheme::fasl_writer w(out);
+        w.write(list);
+        w.write(s);
+        w.write(deep);
+    }
+    const std::string fasl = out.str();
+    uscheme::fasl_reader r(fasl.data(), fasl.data() + fasl.size());
+
+    uscheme::object_ptr q = r.read();
+    uscheme::object_ptr q_items[8];
+    uscheme::object_ptr c = q;
+    for (int i = 0; i != 8; ++i) {
+        q_items[i] = c->car();
+        c = c->cdr();
+    }
+    TEST_TRUE( q_items[0].get() != q_items[1].get() );
+    TEST_TRUE( std::string(q_items[1]->string()) == "s" );
+    TEST_TRUE( q_items[0].get() == c->car().get() );
+    TEST_TRUE( q_items[2].get() == q_items[3].get() );
+    TEST_TRUE( q_items[2]->vector_ref(1).get() == q_items[2].get() );
+    TEST_TRUE( q_items[4].get() == q_items[5].get() && q_items[4]->flonum() == 3.5 );
+    TEST_TRUE( q_items[6].get() == q_items[7].get() && q_items[6]->is_bignum() );
+    TEST_TRUE( c->cdr()->cdr()->cdr()->cdr()->cdr().get() == q.get() );
+
+    /* records do not share cells, only the contents of strings */
+    uscheme::object_ptr s2 = r.read();
+    TEST_TRUE( std::string(s2->string()) == "s" && s2.get() != q_items[0].get() );
+
+    uscheme::object_ptr d = r.read();
+    size_t n = 0;
+    for (; d->is_pair(); d = d->car()) {
+        TEST_TRUE( d->cdr()->is_empty_list() );
+        ++n;
+    }
+    TEST_TRUE( (n == depth) && d->is_empty_list() );
+    TEST_TRUE( r.try_read().status == uscheme::READ_EOS );
+}
+
+CPP_TEST( fasl_errors )
+{
+    const std::string not_fasl = "(not fasl)";
+    try {
+        uscheme::fasl_reader r(not_fasl.data(), not_fasl.data() + not_fasl.size());
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_FASL_HDR );
+    }
+
+    const std::string text = "(a \"b\" #(1.5 123456789012345678901) #\\c -7)";
+    const char* cur = text.data();
+    std::stringstream out;
+    {
+        uscheme::fasl_writer w(out);
+        w.write(uscheme::read_object(cur, text.data() + text.size()));
+    }
+    const std::string fasl = out.str();
+
+    /* every cut inside the record is malformed, and stays so */
+    for (size_t n = 9; n != fasl.size(); ++n) {
+        uscheme::fasl_reader r(fasl.data(), fasl.data() + n);
+        const uscheme::read_result result = r.try_read();
+        TEST_TRUE( result.status == uscheme::READ_ERROR );
+        TEST_TRUE( result.error == uscheme::ERR_FASL_DATA );
+        TEST_TRUE( r.try_read().status == uscheme::READ_ERROR );
+    }
+
+    uscheme::fasl_reader r(fasl.data(), fasl.data() + 8);
+    try {
+        r.read();
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_EOS );
+    }
+
+    /* lengths far beyond the input, from a span and from a stream */
+    const char huge[] = { '\x80', '\x80', '\x80', '\x80', '\x80', '\x80', '\x80', '\x40' };
+    const char tags[] = { 5 /* symbol */, 7 /* string */, 10 /* vector */, 12 /* bignum */, 14 /* list */ };
+    for (size_t i = 0; i != sizeof(tags); ++i) {
+        std::string hostile = fasl.substr(0, 8);
+        if (tags[i] == 12) {
+            hostile += std::string(1, tags[i]) + '\0';
+        } else {
+            hostile += tags[i];
+        }
+        hostile.append(huge, sizeof(huge));
+        hostile += "\x02\x02\x02";
+        uscheme::fasl_reader in_place(hostile.data(), hostile.data() + hostile.size());
+        TEST_TRUE( in_place.try_read().error == uscheme::ERR_FASL_DATA );
+        std::stringstream in(hostile);
+        uscheme::fasl_reader streamed(in);
+        TEST_TRUE( streamed.try_read().error == uscheme::ERR_FASL_DATA );
+    }
+
+    std::string bad = fasl;
+    bad[8] = '\x7f';
+    uscheme::fasl_reader b(bad.data(), bad.data() + bad.size());
+    TEST_TRUE( b.try_read().error == uscheme::ERR_FASL_DATA );
+}
+
+CPP_TEST( fasl_file )
+{
+    const std::string text = many_data(500);
+    const std::vector<uscheme::object_ptr> data = read_all(text);
+    uscheme::object_ptr list = uscheme::empty_list_value();
+    for (size_t i = data.size(); i != 0; --i) {
+        list = uscheme::object::create_pair(data[i - 1], list);
+    }
+    uscheme::write_fasl_file("fasl_file.fasl", list);
+
+    uscheme::object_ptr back = uscheme::read_fasl_file("fasl_file.fasl");
+    TEST_TRUE( to_text(back) == to_text(list) );
+    remove("fasl_file.fasl");
+
+    {
+        std::ofstream out("fasl_file.fasl", std::ios::binary);
+    }
+    try {
+        uscheme::read_fasl_file("fasl_file.fasl");
+        TEST_TRUE( false );
+    } catch (const uscheme::exception& ex) {
+        TEST_TRUE( ex.id() == uscheme::ERR_FASL_HDR );
+    }
+    remove("fasl_file.fasl");
+}
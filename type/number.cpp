@@ -0,0 +1,384 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file number.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// PKG includes
+#include <uscheme/type/number.hpp>
+#include <uscheme/stream/decimal.hpp>
+
+#define ERROR_IF(cond, id)        \
+ if ((cond)) {                    \
+    throw uscheme::exception(id); \
+ }
+
+namespace uscheme {
+
+    /* little endian base 2^32 digits with no leading zeros */
+    typedef std::vector<uint32_t> magnitude;
+
+    /* operands with fewer digits than this are multiplied schoolbook style */
+    static const size_t KARATSUBA_THRESHOLD = 32;
+
+    static const uint32_t DECIMAL_CHUNK = 1000000000u;
+    static const size_t   DECIMAL_CHUNK_DIGITS = 9;
+
+    struct integer
+    {
+        bool      negative;
+        magnitude mag;
+    };
+
+    static void trim(magnitude& m)
+    {
+        while (!m.empty() && (m.back() == 0)) {
+            m.pop_back();
+        }
+    }
+
+    static integer unpack(const object_ptr& p)
+    {
+        ERROR_IF(!is_integer(p), ERR_NOT_INT);
+        integer i;
+        if (p.is_fixnum()) {
+            const long v = p.fixnum();
+            i.negative = v < 0;
+            unsigned long long u = i.negative ? 0ull - static_cast<unsigned long long>(v)
+                                              : static_cast<unsigned long long>(v);
+            for (; u != 0; u >>= 32) {
+                i.mag.push_back(static_cast<uint32_t>(u));
+            }
+        } else {
+            i.negative = p.bignum_negative();
+            i.mag.assign(p.bignum_digits(), p.bignum_digits() + p.bignum_length());
+        }
+        return i;
+    }
+
+    static object_ptr pack(bool negative, magnitude& m)
+    {
+        trim(m);
+        if (m.size() <= 2) {
+            unsigned long long u = 0;
+            if (m.size() == 2) {
+                u = static_cast<unsigned long long>(m[1]) << 32;
+            }
+            if (!m.empty()) {
+                u |= m[0];
+            }
+            const unsigned long long max = static_cast<unsigned long long>(object_ptr::FIXNUM_MAX);
+            if (!negative && (u <= max)) {
+                return object_ptr::from_fixnum(static_cast<long>(u));
+            }
+            if (negative && (u <= max + 1)) {
+                return object_ptr::from_fixnum(-static_cast<long>(u - 1) - 1);
+            }
+        }
+        return object::create_bignum(negative, m.data(), m.size());
+    }
+
+    static int compare_magnitude(const magnitude& a, const magnitude& b)
+    {
+        if (a.size() != b.size()) {
+            return (a.size() < b.size()) ? -1 : 1;
+        }
+        for (size_t i = a.size(); i != 0; --i) {
+            if (a[i - 1] != b[i - 1]) {
+                return (a[i - 1] < b[i - 1]) ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    static magnitude add_magnitude(const magnitude& a, const magnitude& b)
+    {
+        const magnitude& l = (a.size() >= b.size()) ? a : b;
+        const magnitude& s = (a.size() >= b.size()) ? b : a;
+        magnitude r(l.size() + 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i != l.size(); ++i) {
+            carry += l[i];
+            if (i < s.size()) {
+                carry += s[i];
+            }
+            r[i] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        r[l.size()] = static_cast<uint32_t>(carry);
+        trim(r);
+        return r;
+    }
+
+    /* a - b where a >= b */
+    static magnitude sub_magnitude(const magnitude& a, const magnitude& b)
+    {
+        magnitude r(a.size());
+        int64_t borrow = 0;
+        for (size_t i = 0; i != a.size(); ++i) {
+            int64_t d = static_cast<int64_t>(a[i]) - borrow;
+            if (i < b.size()) {
+                d -= b[i];
+            }
+            borrow = (d < 0) ? 1 : 0;
+            r[i] = static_cast<uint32_t>(d + (borrow << 32));
+        }
+        trim(r);
+        return r;
+    }
+
+    /* r += x * 2^(32 * shift); r must have room for the result */
+    static void add_shifted(magnitude& r, const magnitude& x, size_t shift)
+    {
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i != x.size(); ++i) {
+            carry += static_cast<uint64_t>(r[i + shift]) + x[i];
+            r[i + shift] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        for (i += shift; carry != 0; ++i) {
+            carry += r[i];
+            r[i] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+
+    static magnitude mul_schoolbook(const magnitude& a, const magnitude& b)
+    {
+        magnitude r(a.size() + b.size());
+        for (size_t i = 0; i != a.size(); ++i) {
+            uint64_t carry = 0;
+            const uint64_t ai = a[i];
+            for (size_t j = 0; j != b.size(); ++j) {
+                carry += ai * b[j] + r[i + j];
+                r[i + j] = static_cast<uint32_t>(carry);
+                carry >>= 32;
+            }
+            r[i + b.size()] = static_cast<uint32_t>(carry);
+        }
+        trim(r);
+        return r;
+    }
+
+    static magnitude mul_magnitude(const magnitude& a, const magnitude& b);
+
+    static magnitude mul_karatsuba(const magnitude& a, const magnitude& b)
+    {
+        const size_t h = std::max(a.size(), b.size()) / 2;
+
+        magnitude a0(a.begin(), a.begin() + std::min(h, a.size()));
+        magnitude a1(a.begin() + std::min(h, a.size()), a.end());
+        magnitude b0(b.begin(), b.begin() + std::min(h, b.size()));
+        magnitude b1(b.begin() + std::min(h, b.size()), b.end());
+        trim(a0);
+        trim(b0);
+
+        const magnitude z0 = mul_magnitude(a0, b0);
+        const magnitude z2 = mul_magnitude(a1, b1);
+        magnitude z1 = mul_magnitude(add_magnitude(a0, a1), add_magnitude(b0, b1));
+        z1 = sub_magnitude(sub_magnitude(z1, z0), z2);
+
+        magnitude r(a.size() + b.size() + 1);
+        add_shifted(r, z0, 0);
+        add_shifted(r, z1, h);
+        add_shifted(r, z2, 2 * h);
+        trim(r);
+        return r;
+    }
+
+    static magnitude mul_magnitude(const magnitude& a, const magnitude& b)
+    {
+        if (a.empty() || b.empty()) {
+            return magnitude();
+        }
+        if (std::min(a.size(), b.size()) < KARATSUBA_THRESHOLD) {
+            return mul_schoolbook(a, b);
+        }
+        return mul_karatsuba(a, b);
+    }
+
+    /* m = m * mul + add */
+    static void mul_add_small(magnitude& m, uint32_t mul, uint32_t add)
+    {
+        uint64_t carry = add;
+        for (size_t i = 0; i != m.size(); ++i) {
+            carry += static_cast<uint64_t>(m[i]) * mul;
+            m[i] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry != 0) {
+            m.push_back(static_cast<uint32_t>(carry));
+        }
+    }
+
+    /* m = m / d, returning the remainder */
+    static uint32_t div_small(magnitude& m, uint32_t d)
+    {
+        uint64_t rem = 0;
+        for (size_t i = m.size(); i != 0; --i) {
+            rem = (rem << 32) | m[i - 1];
+            m[i - 1] = static_cast<uint32_t>(rem / d);
+            rem %= d;
+        }
+        trim(m);
+        return static_cast<uint32_t>(rem);
+    }
+
+    static object_ptr add_signed(integer& a, integer& b)
+    {
+        if (a.negative == b.negative) {
+            magnitude r = add_magnitude(a.mag, b.mag);
+            return pack(a.negative, r);
+        }
+        const int c = compare_magnitude(a.mag, b.mag);
+        if (c == 0) {
+            return object_ptr::from_fixnum(0);
+        }
+        magnitude r = (c > 0) ? sub_magnitude(a.mag, b.mag) : sub_magnitude(b.mag, a.mag);
+        return pack((c > 0) ? a.negative : b.negative, r);
+    }
+
+    object_ptr make_integer(long value)
+    {
+        if ((value >= object_ptr::FIXNUM_MIN) && (value <= object_ptr::FIXNUM_MAX)) {
+            return object_ptr::from_fixnum(value);
+        }
+        const bool negative = value < 0;
+        unsigned long long u = negative ? 0ull - static_cast<unsigned long long>(value)
+                                        : static_cast<unsigned long long>(value);
+        magnitude m;
+        for (; u != 0; u >>= 32) {
+            m.push_back(static_cast<uint32_t>(u));
+        }
+        return pack(negative, m);
+    }
+
+    object_ptr integer_from_decimal(const char* digits, size_t ndigits, bool negative)
+    {
+        magnitude m;
+        m.reserve(ndigits / DECIMAL_CHUNK_DIGITS + 1);
+        size_t i = 0;
+        /* a short leading chunk so the rest are whole */
+        size_t n = ndigits % DECIMAL_CHUNK_DIGITS;
+        if (n == 0) {
+            n = DECIMAL_CHUNK_DIGITS;
+        }
+        while (i != ndigits) {
+            uint32_t chunk = 0;
+            uint32_t scale = 1;
+            for (size_t j = 0; j != n; ++j) {
+                chunk = chunk * 10 + static_cast<uint32_t>(digits[i + j] - '0');
+                scale *= 10;
+            }
+            mul_add_small(m, scale, chunk);
+            i += n;
+            n = DECIMAL_CHUNK_DIGITS;
+        }
+        return pack(negative, m);
+    }
+
+    object_ptr integer_from_digits(const char* digits, size_t ndigits, unsigned radix,
+                                   bool negative)
+    {
+        if (radix == 10) {
+            return integer_from_decimal(digits, ndigits, negative);
+        }
+        magnitude m;
+        for (size_t i = 0; i != ndigits; ++i) {
+            mul_add_small(m, radix, digit_value(digits[i]));
+        }
+        return pack(negative, m);
+    }
+
+    std::string integer_to_string(const object_ptr& p)
+    {
+        integer i = unpack(p);
+        if (i.mag.empty()) {
+            return "0";
+        }
+
+        std::vector<uint32_t> chunks;
+        while (!i.mag.empty()) {
+            chunks.push_back(div_small(i.mag, DECIMAL_CHUNK));
+        }
+
+        std::string s;
+        s.reserve(chunks.size() * DECIMAL_CHUNK_DIGITS + 1);
+        if (i.negative) {
+            s.push_back('-');
+        }
+        char buf[FORMAT_BUFFER_SIZE];
+        s.append(buf, format_integer(chunks.back(), buf));
+        for (size_t k = chunks.size() - 1; k != 0; --k) {
+            const size_t n = format_integer(chunks[k - 1], buf);
+            s.append(DECIMAL_CHUNK_DIGITS - n, '0');
+            s.append(buf, n);
+        }
+        return s;
+    }
+
+    object_ptr integer_add_slow(const object_ptr& a, const object_ptr& b)
+    {
+        integer x = unpack(a);
+        integer y = unpack(b);
+        return add_signed(x, y);
+    }
+
+    object_ptr integer_sub_slow(const object_ptr& a, const object_ptr& b)
+    {
+        integer x = unpack(a);
+        integer y = unpack(b);
+        y.negative = !y.negative;
+        return add_signed(x, y);
+    }
+
+    object_ptr integer_mul_slow(const object_ptr& a, const object_ptr& b)
+    {
+        integer x = unpack(a);
+        integer y = unpack(b);
+        magnitude r = mul_magnitude(x.mag, y.mag);
+        return pack(x.negative != y.negative, r);
+    }
+
+    int integer_compare_slow(const object_ptr& a, const object_ptr& b)
+    {
+        integer x = unpack(a);
+        integer y = unpack(b);
+        if (x.negative != y.negative) {
+            return x.negative ? -1 : 1;
+        }
+        const int c = compare_magnitude(x.mag, y.mag);
+        return x.negative ? -c : c;
+    }
+
+}//namespace uscheme
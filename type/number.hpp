@@ -0,0 +1,201 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file number.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_TYPE_NUMBER_HPP
+#define USCHEME_TYPE_NUMBER_HPP
+
+// LANG includes
+#include <cstddef>
+#include <string>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/except.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    /**
+     * Integers are exact and of unbounded size. A value is a FIXNUM when it
+     * fits in [FIXNUM_MIN, FIXNUM_MAX] and a BIGNUM otherwise, so equal
+     * integers always have the same representation.
+     *
+     * The arithmetic below is inline for two fixnums and only leaves that
+     * path when the machine add, subtract or multiply overflows or the
+     * result leaves the fixnum range.
+     */
+
+    USCHEME_INLINE
+    bool checked_add(long a, long b, long* r)
+    {
+#if defined(__GNUC__)
+        return __builtin_add_overflow(a, b, r);
+#else
+        if ((b > 0) ? (a > LONG_MAX - b) : (a < LONG_MIN - b)) {
+            return true;
+        }
+        *r = a + b;
+        return false;
+#endif
+    }
+
+    USCHEME_INLINE
+    bool checked_sub(long a, long b, long* r)
+    {
+#if defined(__GNUC__)
+        return __builtin_sub_overflow(a, b, r);
+#else
+        if ((b < 0) ? (a > LONG_MAX + b) : (a < LONG_MIN + b)) {
+            return true;
+        }
+        *r = a - b;
+        return false;
+#endif
+    }
+
+    USCHEME_INLINE
+    bool checked_mul(long a, long b, long* r)
+    {
+#if defined(__GNUC__)
+        return __builtin_mul_overflow(a, b, r);
+#else
+        if (a != 0 && b != 0) {
+            const long long p = static_cast<long long>(a) * b;
+            if ((p / b != a) || (p > LONG_MAX) || (p < LONG_MIN)) {
+                return true;
+            }
+        }
+        *r = a * b;
+        return false;
+#endif
+    }
+
+    USCHEME_INLINE
+    bool is_integer(const object_ptr& p)
+    {
+        return p.is_fixnum() || p.is_bignum();
+    }
+
+    USCHEME_API
+    /**
+     * The integer value of a long that may not fit a fixnum.
+     */
+    object_ptr make_integer(long value);
+
+    USCHEME_API
+    /**
+     * The integer written as ndigits decimal digits.
+     */
+    object_ptr integer_from_decimal(const char* digits, size_t ndigits,
+                                    bool negative);
+
+    USCHEME_API
+    /**
+     * The integer written as ndigits digits of radix 2, 8, 10 or 16.
+     */
+    object_ptr integer_from_digits(const char* digits, size_t ndigits, unsigned radix,
+                                   bool negative);
+
+    USCHEME_API
+    /**
+     * Decimal representation of an integer.
+     */
+    std::string integer_to_string(const object_ptr& p);
+
+    USCHEME_API
+    object_ptr integer_add_slow(const object_ptr& a, const object_ptr& b);
+
+    USCHEME_API
+    object_ptr integer_sub_slow(const object_ptr& a, const object_ptr& b);
+
+    USCHEME_API
+    object_ptr integer_mul_slow(const object_ptr& a, const object_ptr& b);
+
+    USCHEME_API
+    int integer_compare_slow(const object_ptr& a, const object_ptr& b);
+
+    /**
+     * a + b. Throws ERR_NOT_INT unless both are integers.
+     */
+    USCHEME_INLINE
+    object_ptr integer_add(const object_ptr& a, const object_ptr& b)
+    {
+        long r;
+        if (a.is_fixnum() && b.is_fixnum() && !checked_add(a.fixnum(), b.fixnum(), &r) &&
+            (r >= object_ptr::FIXNUM_MIN) && (r <= object_ptr::FIXNUM_MAX)) {
+            return object_ptr::from_fixnum(r);
+        }
+        return integer_add_slow(a, b);
+    }
+
+    /**
+     * a - b. Throws ERR_NOT_INT unless both are integers.
+     */
+    USCHEME_INLINE
+    object_ptr integer_sub(const object_ptr& a, const object_ptr& b)
+    {
+        long r;
+        if (a.is_fixnum() && b.is_fixnum() && !checked_sub(a.fixnum(), b.fixnum(), &r) &&
+            (r >= object_ptr::FIXNUM_MIN) && (r <= object_ptr::FIXNUM_MAX)) {
+            return object_ptr::from_fixnum(r);
+        }
+        return integer_sub_slow(a, b);
+    }
+
+    /**
+     * a * b. Throws ERR_NOT_INT unless both are integers.
+     */
+    USCHEME_INLINE
+    object_ptr integer_mul(const object_ptr& a, const object_ptr& b)
+    {
+        long r;
+        if (a.is_fixnum() && b.is_fixnum() && !checked_mul(a.fixnum(), b.fixnum(), &r) &&
+            (r >= object_ptr::FIXNUM_MIN) && (r <= object_ptr::FIXNUM_MAX)) {
+            return object_ptr::from_fixnum(r);
+        }
+        return integer_mul_slow(a, b);
+    }
+
+    /**
+     * Negative, zero or positive as a is less than, equal to or greater
+     * than b. Throws ERR_NOT_INT unless both are integers.
+     */
+    USCHEME_INLINE
+    int integer_compare(const object_ptr& a, const object_ptr& b)
+    {
+        if (a.is_fixnum() && b.is_fixnum()) {
+            return (a.fixnum() < b.fixnum()) ? -1 : (a.fixnum() > b.fixnum()) ? 1 : 0;
+        }
+        return integer_compare_slow(a, b);
+    }
+
+}//namespace uscheme
+
+#endif//USCHEME_TYPE_NUMBER_HPP
@@ -29,49 +29,90 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
 // LANG includes
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <new>
 
 // PKG includes
 #include <uscheme/type/type.hpp>
 #include <uscheme/type/object.hpp>
-
-#if defined(_WIN32)
-#  define STRDUP _strdup
-#else
-#  define STRDUP strdup
-#endif//defined(_WIN32)
+#include <uscheme/type/number.hpp>
+#include <uscheme/gc/slab.hpp>
 
 namespace uscheme {
 
-    static const object_ptr TRUE  = object::create_boolean(true);
-    static const object_ptr FALSE = object::create_boolean(false);
-    static const object_ptr EMPTY = object::create_empty_list();
+    void object::init_string(const char* value, size_t length)
+    {
+        data_.string.length = static_cast<uint32_t>(length);
+        char* chars = data_.small_string.chars;
+        if (length > STRING_INLINE_MAX) {
+            chars = static_cast<char*>(slab_allocate(length + 1));
+            data_.string.value = chars;
+        }
+        memcpy(chars, value, length);
+        chars[length] = '\0';
+    }
 
-    object_ptr true_value(void)
+    object_ptr object::create_list(const object_ptr* items, size_t count,
+                                   const object_ptr& tail)
     {
-        return TRUE;
+        if (count == 0) {
+            return tail;
+        }
+        object* first = nullptr;
+        object* prev = nullptr;
+        for (size_t i = 0; i != count; ++i) {
+            object* ptr = new (gc_allocate(pair_size())) object(PAIR);
+            ptr->data_.pair.car = items[i];
+            if (prev) {
+                prev->data_.pair.cdr = object_ptr::from_object(ptr);
+            } else {
+                first = ptr;
+            }
+            prev = ptr;
+        }
+        prev->data_.pair.cdr = tail;
+        return object_ptr::from_object(first);
     }
 
-    object_ptr false_value(void)
+    object_ptr object::create_vector(size_t length, const object_ptr& fill)
     {
-        return FALSE;
+        if (length > (SIZE_MAX - vector_size(0)) / sizeof(object_ptr)) {
+            throw std::bad_alloc();
+        }
+        object* ptr = new (gc_allocate(vector_size(length))) object(VECTOR);
+        ptr->data_.vector.length = length;
+        std::fill(ptr->data_.vector.elements, ptr->data_.vector.elements + length, fill);
+        return object_ptr::from_object(ptr);
     }
 
-    object_ptr empty_list_value(void)
+    object_ptr object::create_fixnum_overflow(long value)
     {
-        return EMPTY;
+        return make_integer(value);
     }
 
-    void object::init_string(const char* value)
+    object_ptr object::create_bignum(bool negative, const uint32_t* digits,
+                                     size_t length)
     {
-        data_.string.value = STRDUP(value);
+        if (length > UINT32_MAX) {
+            throw std::bad_alloc();
+        }
+        object* ptr = new (gc_allocate(bignum_size(length))) object(BIGNUM);
+        ptr->data_.bignum.length = static_cast<uint32_t>(length);
+        ptr->data_.bignum.negative = negative ? 1 : 0;
+        memcpy(ptr->data_.bignum.digits, digits, length * sizeof(uint32_t));
+        return object_ptr::from_object(ptr);
     }
 
     void object::destroy()
     {
         switch (type_) {
             case STRING: {
-                free((void*)data_.string.value);
+                if (data_.string.length > STRING_INLINE_MAX) {
+                    slab_free((void*)data_.string.value, data_.string.length + 1);
+                }
                 break;
             }
             default: {
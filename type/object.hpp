@@ -32,191 +32,708 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define USCHEME_TYPE_OBJECT_HPP
 
 // LANG includes
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
-#include <memory>
+#include <cstring>
+#include <new>
 
 // PKG includes
 #include <uscheme/defs.hpp>
 #include <uscheme/type/type.hpp>
+#include <uscheme/type/symbol.hpp>
+#include <uscheme/gc/heap.hpp>
 
 namespace uscheme {
 
     struct object;
 
     /**
+     * Tagged value handle.
      *
-     */
-    typedef std::shared_ptr<object> object_ptr;
-
-    /**
+     * FIXNUM, BOOLEAN, CHARACTER and EMPTY_LIST values are encoded directly
+     * in the handle word and never touch the heap. A SYMBOL is a tagged
+     * pointer to its interned name, which is never collected. Every other
+     * type is a pointer to a cell on the garbage collected heap. Handles are plain
+     * words: copying one costs nothing, and a handle held by C++ code keeps
+     * its object alive only while registered with a gc_root.
      *
+     * Word layout (low bits):
+     *   ...xxxx1 FIXNUM, value in the upper bits
+     *   ...xx000 heap object pointer
+     *   ...xx100 interned symbol pointer
+     *   00001010 BOOLEAN, value in the upper bits
+     *   00010010 CHARACTER, value in the upper bits
+     *   00011010 EMPTY_LIST
      */
-    struct object
+    class object_ptr
     {
+      public:
+        typedef uintptr_t word;
+
+        static const word FIXNUM_MASK    = 0x01;
+        static const word FIXNUM_TAG     = 0x01;
+        static const word HEAP_MASK      = 0x07;
+        static const word HEAP_TAG       = 0x00;
+        static const word SYMBOL_TAG     = 0x04;
+        static const word IMMEDIATE_MASK = 0xff;
+        static const word BOOLEAN_TAG    = 0x0a;
+        static const word CHARACTER_TAG  = 0x12;
+        static const word EMPTY_LIST_TAG = 0x1a;
+        static const int  IMMEDIATE_SHIFT = 8;
+
+        static const long FIXNUM_MAX = ((INTPTR_MAX >> 1) < LONG_MAX)
+                                     ? static_cast<long>(INTPTR_MAX >> 1) : LONG_MAX;
+        static const long FIXNUM_MIN = -FIXNUM_MAX - 1;
+
+        USCHEME_INLINE
+        object_ptr()
+          : bits_(0)
+        { }
 
         //////////////////////////////////////////////////////////////////////////
         // Static methods
         //////////////////////////////////////////////////////////////////////////
 
+        /**
+         * The value must be in [FIXNUM_MIN, FIXNUM_MAX]; object::create_fixnum
+         * takes any long.
+         */
         static USCHEME_INLINE
-        object_ptr create_fixnum(long value)
+        object_ptr from_fixnum(long value)
         {
-            object_ptr ptr(new object);
-            ptr->type_ = FIXNUM;
-            ptr->data_.fixnum.value = value;
-            return ptr;
+            assert((value >= FIXNUM_MIN) && (value <= FIXNUM_MAX));
+            return object_ptr((static_cast<word>(value) << 1) | FIXNUM_TAG);
         }
 
         static USCHEME_INLINE
-        object_ptr create_boolean(bool value)
+        object_ptr from_boolean(bool value)
         {
-            object_ptr ptr(new object);
-            ptr->type_ = BOOLEAN;
-            ptr->data_.boolean.value = value ? 1 : 0;
-            return ptr;
+            return object_ptr(
+                (static_cast<word>(value ? 1 : 0) << IMMEDIATE_SHIFT) | BOOLEAN_TAG);
         }
 
         static USCHEME_INLINE
-        object_ptr create_character(char value)
+        object_ptr from_character(char value)
         {
-            object_ptr ptr(new object);
-            ptr->type_ = CHARACTER;
-            ptr->data_.character.value = value;
-            return ptr;
+            return object_ptr(
+                (static_cast<word>(static_cast<unsigned char>(value)) << IMMEDIATE_SHIFT)
+                | CHARACTER_TAG);
         }
 
         static USCHEME_INLINE
-        object_ptr create_string(const char* value)
+        object_ptr from_empty_list()
         {
-            object_ptr ptr(new object);
-            ptr->type_ = STRING;
-            ptr->init_string(value);
-            return ptr;
+            return object_ptr(EMPTY_LIST_TAG);
         }
 
         static USCHEME_INLINE
-        object_ptr create_empty_list()
+        object_ptr from_symbol(const symbol* sym)
+        {
+            return object_ptr(reinterpret_cast<word>(sym) | SYMBOL_TAG);
+        }
+
+        static USCHEME_INLINE
+        object_ptr from_object(object* p)
         {
-            object_ptr ptr(new object);
-            ptr->type_ = EMPTY_LIST;
-            return ptr;
+            return object_ptr(reinterpret_cast<word>(p));
         }
 
         //////////////////////////////////////////////////////////////////////////
         // Instance methods
         //////////////////////////////////////////////////////////////////////////
 
+        /**
+         * Kept so that code written against the object pointer (p->fixnum())
+         * works unchanged on the tagged handle.
+         */
         USCHEME_INLINE
-        object_type type() const
+        const object_ptr* operator->() const
+        {
+            return this;
+        }
+
+        /**
+         * The identity of the value. Only dereferenceable when is_heap().
+         */
+        USCHEME_INLINE
+        object* get() const
+        {
+            return reinterpret_cast<object*>(bits_);
+        }
+
+        USCHEME_INLINE
+        word bits() const
         {
-            return type_;
+            return bits_;
         }
 
+        USCHEME_INLINE
+        explicit operator bool() const
+        {
+            return bits_ != 0;
+        }
+
+        USCHEME_INLINE
+        bool is_heap() const
+        {
+            return ((bits_ & HEAP_MASK) == HEAP_TAG) && (bits_ != 0);
+        }
+
+        object_type type() const;
+
         USCHEME_INLINE
         bool is_fixnum() const
         {
-            return type_ == FIXNUM;
+            return (bits_ & FIXNUM_MASK) == FIXNUM_TAG;
         }
 
         USCHEME_INLINE
         bool is_boolean() const
         {
-            return type_ == BOOLEAN;
+            return (bits_ & IMMEDIATE_MASK) == BOOLEAN_TAG;
         }
 
         USCHEME_INLINE
         bool is_character() const
         {
-            return type_ == CHARACTER;
+            return (bits_ & IMMEDIATE_MASK) == CHARACTER_TAG;
         }
 
+        bool is_string() const;
+
         USCHEME_INLINE
-        bool is_string() const
+        bool is_symbol() const
         {
-            return type_ == STRING;
+            return (bits_ & HEAP_MASK) == SYMBOL_TAG;
         }
 
         USCHEME_INLINE
         bool is_empty_list() const
         {
-            return type_ == EMPTY_LIST;
+            return bits_ == EMPTY_LIST_TAG;
         }
 
         USCHEME_INLINE
         long fixnum() const
         {
-            return data_.fixnum.value;
+            return static_cast<long>(static_cast<intptr_t>(bits_) >> 1);
         }
 
         USCHEME_INLINE
         bool boolean() const
         {
-            return data_.boolean.value != 0;
+            return (bits_ >> IMMEDIATE_SHIFT) != 0;
         }
 
         USCHEME_INLINE
         char character() const
         {
-            return data_.character.value;
+            return static_cast<char>(bits_ >> IMMEDIATE_SHIFT);
+        }
+
+        const char* string() const;
+
+        size_t string_length() const;
+
+        USCHEME_INLINE
+        const symbol* interned() const
+        {
+            return reinterpret_cast<const symbol*>(bits_ & ~HEAP_MASK);
         }
 
         USCHEME_INLINE
-        const char* string() const
+        const char* symbol_name() const
         {
-            return data_.string.value;
+            return interned()->name;
         }
 
-        ~object()
+        USCHEME_INLINE
+        size_t symbol_length() const
         {
-            destroy();
+            return interned()->length;
         }
 
+        bool is_pair() const;
+
+        object_ptr car() const;
+
+        object_ptr cdr() const;
+
+        void set_car(const object_ptr& value) const;
+
+        void set_cdr(const object_ptr& value) const;
+
+        bool is_vector() const;
+
+        bool is_bignum() const;
+
+        bool is_flonum() const;
+
+        double flonum() const;
+
+        bool bignum_negative() const;
+
+        size_t bignum_length() const;
+
+        const uint32_t* bignum_digits() const;
+
+        size_t vector_length() const;
+
+        object_ptr* vector_data() const;
+
+        object_ptr vector_ref(size_t k) const;
+
+        void vector_set(size_t k, const object_ptr& value) const;
+
       private:
-        object()
-          : type_(FIXNUM)
-          , data_()
+        explicit object_ptr(word bits)
+          : bits_(bits)
+        { }
+
+        word bits_;
+    };
+
+    /**
+     * Heap cell. Only types that cannot be encoded in an object_ptr word
+     * live here. Cells are owned by the collector, which frees them once
+     * they are unreachable; there is no destructor.
+     *
+     * Cells are sized per type and value: a STRING of at most
+     * STRING_INLINE_MAX bytes keeps its characters in the cell itself, a
+     * longer one points to a slab allocated buffer. A PAIR is the collector
+     * header followed by two tagged words, and a VECTOR is the header, its
+     * length and one contiguous run of tagged words. A BIGNUM holds its sign
+     * and magnitude inline, as little endian base 2^32 digits, and a FLONUM
+     * is a boxed double.
+     */
+    struct object
+    {
+        static const size_t STRING_INLINE_MAX = 19;
+
+        //////////////////////////////////////////////////////////////////////////
+        // Static methods
+        //////////////////////////////////////////////////////////////////////////
+
+        /**
+         * A fixnum, or a bignum for a value outside [FIXNUM_MIN, FIXNUM_MAX].
+         */
+        static USCHEME_INLINE
+        object_ptr create_fixnum(long value)
+        {
+            if ((value < object_ptr::FIXNUM_MIN) || (value > object_ptr::FIXNUM_MAX)) {
+                return create_fixnum_overflow(value);
+            }
+            return object_ptr::from_fixnum(value);
+        }
+
+        USCHEME_API
+        static object_ptr create_fixnum_overflow(long value);
+
+        static USCHEME_INLINE
+        object_ptr create_boolean(bool value)
+        {
+            return object_ptr::from_boolean(value);
+        }
+
+        static USCHEME_INLINE
+        object_ptr create_character(char value)
+        {
+            return object_ptr::from_character(value);
+        }
+
+        static USCHEME_INLINE
+        object_ptr create_string(const char* value, size_t length)
+        {
+            if (length > UINT32_MAX) {
+                throw std::bad_alloc();
+            }
+            object* ptr = new (gc_allocate(string_size(length))) object(STRING);
+            ptr->init_string(value, length);
+            return object_ptr::from_object(ptr);
+        }
+
+        static USCHEME_INLINE
+        object_ptr create_string(const char* value)
+        {
+            return create_string(value, strlen(value));
+        }
+
+        static USCHEME_INLINE
+        object_ptr create_symbol(const char* name, size_t length)
+        {
+            return object_ptr::from_symbol(intern(name, length));
+        }
+
+        static USCHEME_INLINE
+        object_ptr create_symbol(const char* name)
+        {
+            return create_symbol(name, strlen(name));
+        }
+
+        static USCHEME_INLINE
+        object_ptr create_pair(const object_ptr& car, const object_ptr& cdr)
+        {
+            object* ptr = new (gc_allocate(pair_size())) object(PAIR);
+            ptr->data_.pair.car = car;
+            ptr->data_.pair.cdr = cdr;
+            return object_ptr::from_object(ptr);
+        }
+
+        /**
+         * Build the list of count items ending in tail. The pairs are
+         * allocated in order, so a cdr walk runs forward through memory.
+         */
+        USCHEME_API
+        static object_ptr create_list(const object_ptr* items, size_t count,
+                                      const object_ptr& tail);
+
+        /**
+         * A vector of length elements, all set to fill.
+         */
+        USCHEME_API
+        static object_ptr create_vector(size_t length, const object_ptr& fill);
+
+        /**
+         * A bignum from a magnitude with no leading zero digits. Values
+         * that fit a fixnum must be created with create_fixnum instead; see
+         * number.hpp.
+         */
+        USCHEME_API
+        static object_ptr create_bignum(bool negative, const uint32_t* digits,
+                                        size_t length);
+
+        static USCHEME_INLINE
+        object_ptr create_flonum(double value)
         {
-            data_.fixnum.value = 0;
+            object* ptr = new (gc_allocate(flonum_size())) object(FLONUM);
+            ptr->data_.flonum = value;
+            return object_ptr::from_object(ptr);
         }
 
-        enum object_type type_;
-        union {
+        static USCHEME_INLINE
+        object_ptr create_empty_list()
+        {
+            return object_ptr::from_empty_list();
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        // Instance methods
+        //////////////////////////////////////////////////////////////////////////
+
+        USCHEME_INLINE
+        object_type type() const
+        {
+            return static_cast<object_type>(type_);
+        }
+
+        USCHEME_INLINE
+        const char* string() const
+        {
+            return (data_.string.length <= STRING_INLINE_MAX)
+                 ? data_.small_string.chars
+                 : data_.string.value;
+        }
+
+        USCHEME_INLINE
+        size_t string_length() const
+        {
+            return data_.string.length;
+        }
+
+        USCHEME_INLINE
+        const object_ptr& car() const
+        {
+            return data_.pair.car;
+        }
+
+        USCHEME_INLINE
+        const object_ptr& cdr() const
+        {
+            return data_.pair.cdr;
+        }
+
+        USCHEME_INLINE
+        size_t vector_length() const
+        {
+            return data_.vector.length;
+        }
+
+      private:
+        friend class object_ptr;
+        friend class heap;
+
+        /* data_ is left to the init_ functions: a cell may be smaller */
+        explicit object(object_type t)
+          : type_(static_cast<uint8_t>(t))
+          , mark_(0)
+          , flags_(0)
+        { }
+
+        uint8_t type_;
+        uint8_t mark_;
+        uint8_t flags_;
+        union cell_data {
+            /* members are set by the create_ functions */
+            cell_data() { }
+
             struct {
-                long value;
-            } fixnum;
+                object_ptr car;
+                object_ptr cdr;
+            } pair;
             struct {
-                char value;
-            } boolean;
+                size_t     length;
+                object_ptr elements[1]; /* actually length */
+            } vector;
+            double flonum;
             struct {
-                char value;
-            } character;
+                uint32_t length;
+                uint32_t negative;
+                uint32_t digits[1]; /* actually length */
+            } bignum;
             struct {
+                uint32_t    length;
                 const char* value;
             } string;
+            struct {
+                uint32_t length;
+                char     chars[STRING_INLINE_MAX + 1];
+            } small_string;
+            /* new address of a young cell copied out by the minor collector */
+            object* forward;
         } data_;
 
-        void init_string(const char* val);
+        static USCHEME_INLINE
+        size_t string_size(size_t length)
+        {
+            return (length <= STRING_INLINE_MAX)
+                 ? offsetof(object, data_.small_string.chars) + length + 1
+                 : offsetof(object, data_.string) + sizeof(data_.string);
+        }
+
+        static USCHEME_INLINE
+        size_t pair_size()
+        {
+            return offsetof(object, data_.pair) + sizeof(data_.pair);
+        }
+
+        static USCHEME_INLINE
+        size_t vector_size(size_t length)
+        {
+            return offsetof(object, data_.vector.elements) + length * sizeof(object_ptr);
+        }
+
+        static USCHEME_INLINE
+        size_t bignum_size(size_t length)
+        {
+            return offsetof(object, data_.bignum.digits) + length * sizeof(uint32_t);
+        }
+
+        static USCHEME_INLINE
+        size_t flonum_size()
+        {
+            return offsetof(object, data_.flonum) + sizeof(double);
+        }
+
+        /* bytes occupied by this cell */
+        USCHEME_INLINE
+        size_t size() const
+        {
+            switch (type()) {
+                case STRING: return string_size(data_.string.length);
+                case PAIR:   return pair_size();
+                case VECTOR: return vector_size(data_.vector.length);
+                case BIGNUM: return bignum_size(data_.bignum.length);
+                case FLONUM: return flonum_size();
+                default:     return sizeof(object);
+            }
+        }
+
+        USCHEME_API void init_string(const char* val, size_t length);
 
+        /* release what the cell owns outside the heap; run by the sweeper */
         void destroy();
     };
 
-    USCHEME_API
+    USCHEME_INLINE
+    object_type object_ptr::type() const
+    {
+        if (is_fixnum()) {
+            return FIXNUM;
+        }
+        if (is_symbol()) {
+            return SYMBOL;
+        }
+        switch (bits_ & IMMEDIATE_MASK) {
+            case BOOLEAN_TAG:    return BOOLEAN;
+            case CHARACTER_TAG:  return CHARACTER;
+            case EMPTY_LIST_TAG: return EMPTY_LIST;
+            default:             return get()->type();
+        }
+    }
+
+    USCHEME_INLINE
+    bool object_ptr::is_string() const
+    {
+        return is_heap() && (get()->type() == STRING);
+    }
+
+    USCHEME_INLINE
+    const char* object_ptr::string() const
+    {
+        return get()->string();
+    }
+
+    USCHEME_INLINE
+    size_t object_ptr::string_length() const
+    {
+        return get()->string_length();
+    }
+
+    /**
+     * Call after storing value into a reference field of an existing cell.
+     * Initializing stores need no barrier: a cell allocated outside the
+     * nursery starts out remembered.
+     */
+    USCHEME_INLINE
+    void gc_write_barrier(object* owner, const object_ptr& value)
+    {
+        if (value.is_heap() && gc_is_young(value.get()) && !gc_is_young(owner)) {
+            gc_remember(owner);
+        }
+    }
+
+    USCHEME_INLINE
+    bool object_ptr::is_pair() const
+    {
+        return is_heap() && (get()->type() == PAIR);
+    }
+
+    USCHEME_INLINE
+    object_ptr object_ptr::car() const
+    {
+        return get()->car();
+    }
+
+    USCHEME_INLINE
+    object_ptr object_ptr::cdr() const
+    {
+        return get()->cdr();
+    }
+
+    USCHEME_INLINE
+    void object_ptr::set_car(const object_ptr& value) const
+    {
+        get()->data_.pair.car = value;
+        gc_write_barrier(get(), value);
+    }
+
+    USCHEME_INLINE
+    void object_ptr::set_cdr(const object_ptr& value) const
+    {
+        get()->data_.pair.cdr = value;
+        gc_write_barrier(get(), value);
+    }
+
+    USCHEME_INLINE
+    bool object_ptr::is_vector() const
+    {
+        return is_heap() && (get()->type() == VECTOR);
+    }
+
+    USCHEME_INLINE
+    size_t object_ptr::vector_length() const
+    {
+        return get()->vector_length();
+    }
+
+    /**
+     * The elements, for reading. Stores must go through vector_set() or the
+     * vector primitives, which run the write barrier.
+     */
+    USCHEME_INLINE
+    object_ptr* object_ptr::vector_data() const
+    {
+        return get()->data_.vector.elements;
+    }
+
+    USCHEME_INLINE
+    bool object_ptr::is_bignum() const
+    {
+        return is_heap() && (get()->type() == BIGNUM);
+    }
+
+    USCHEME_INLINE
+    bool object_ptr::is_flonum() const
+    {
+        return is_heap() && (get()->type() == FLONUM);
+    }
+
+    USCHEME_INLINE
+    double object_ptr::flonum() const
+    {
+        return get()->data_.flonum;
+    }
+
+    USCHEME_INLINE
+    bool object_ptr::bignum_negative() const
+    {
+        return get()->data_.bignum.negative != 0;
+    }
+
+    USCHEME_INLINE
+    size_t object_ptr::bignum_length() const
+    {
+        return get()->data_.bignum.length;
+    }
+
+    USCHEME_INLINE
+    const uint32_t* object_ptr::bignum_digits() const
+    {
+        return get()->data_.bignum.digits;
+    }
+
+    USCHEME_INLINE
+    object_ptr object_ptr::vector_ref(size_t k) const
+    {
+        return vector_data()[k];
+    }
+
+    USCHEME_INLINE
+    void object_ptr::vector_set(size_t k, const object_ptr& value) const
+    {
+        vector_data()[k] = value;
+        gc_write_barrier(get(), value);
+    }
+
     /**
      *
      */
-    object_ptr true_value(void);
+    USCHEME_INLINE
+    object_ptr true_value(void)
+    {
+        return object_ptr::from_boolean(true);
+    }
 
-    USCHEME_API
     /**
      *
      */
-    object_ptr false_value(void);
+    USCHEME_INLINE
+    object_ptr false_value(void)
+    {
+        return object_ptr::from_boolean(false);
+    }
 
-    USCHEME_API
     /**
      *
      */
-    object_ptr empty_list_value(void);
+    USCHEME_INLINE
+    object_ptr empty_list_value(void)
+    {
+        return object_ptr::from_empty_list();
+    }
 
 }//namespace uscheme
 
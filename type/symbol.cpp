@@ -0,0 +1,197 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file symbol.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+// PKG includes
+#include <uscheme/type/symbol.hpp>
+
+namespace uscheme {
+
+    /**
+     * Open addressing table with linear probing. Slots carry the hash so a
+     * probe only touches the name of a symbol whose hash matches; names are
+     * bump allocated from arena blocks that are never freed.
+     */
+    class symbol_table
+    {
+      public:
+        symbol_table()
+          : slots_(nullptr)
+          , mask_(0)
+          , count_(0)
+          , arena_top_(nullptr)
+          , arena_end_(nullptr)
+        {
+            resize(INITIAL_CAPACITY);
+        }
+
+        const symbol* intern(const char* name, size_t length)
+        {
+            const uint32_t h = hash(name, length);
+            size_t i = h & mask_;
+            for (;;) {
+                const slot& s = slots_[i];
+                if (!s.sym) {
+                    break;
+                }
+                if (s.hash == h && s.sym->length == length &&
+                    memcmp(s.sym->name, name, length) == 0) {
+                    return s.sym;
+                }
+                i = (i + 1) & mask_;
+            }
+
+            symbol* sym = make_symbol(name, length, h);
+            slots_[i].hash = h;
+            slots_[i].sym = sym;
+            if (++count_ * 2 > mask_ + 1) {
+                resize((mask_ + 1) * 2);
+            }
+            return sym;
+        }
+
+        size_t count() const
+        {
+            return count_;
+        }
+
+      private:
+        static const size_t INITIAL_CAPACITY = 1 << 10;
+        static const size_t ARENA_BLOCK_SIZE = 1 << 16;
+        static const size_t SYMBOL_ALIGN = 8;
+
+        struct slot
+        {
+            uint32_t      hash;
+            const symbol* sym;
+        };
+
+        /* FNV-1a */
+        static uint32_t hash(const char* name, size_t length)
+        {
+            uint32_t h = 2166136261u;
+            for (size_t i = 0; i != length; ++i) {
+                h ^= static_cast<unsigned char>(name[i]);
+                h *= 16777619u;
+            }
+            return h;
+        }
+
+        void resize(size_t capacity)
+        {
+            slot* slots = static_cast<slot*>(calloc(capacity, sizeof(slot)));
+            if (!slots) {
+                throw std::bad_alloc();
+            }
+            const size_t mask = capacity - 1;
+            for (size_t i = 0; i != mask_ + 1 && slots_; ++i) {
+                const slot& s = slots_[i];
+                if (s.sym) {
+                    size_t j = s.hash & mask;
+                    while (slots[j].sym) {
+                        j = (j + 1) & mask;
+                    }
+                    slots[j] = s;
+                }
+            }
+            free(slots_);
+            slots_ = slots;
+            mask_ = mask;
+        }
+
+        symbol* make_symbol(const char* name, size_t length, uint32_t h)
+        {
+            if (length > UINT32_MAX) {
+                throw std::bad_alloc();
+            }
+            /* object_ptr keeps its tag in the low three bits */
+            size_t size = offsetof(symbol, name) + length + 1;
+            size = (size + SYMBOL_ALIGN - 1) & ~(SYMBOL_ALIGN - 1);
+
+            char* p;
+            if (size > ARENA_BLOCK_SIZE / 4) {
+                p = static_cast<char*>(malloc(size));
+                if (!p) {
+                    throw std::bad_alloc();
+                }
+            } else {
+                if (static_cast<size_t>(arena_end_ - arena_top_) < size) {
+                    arena_top_ = static_cast<char*>(malloc(ARENA_BLOCK_SIZE));
+                    if (!arena_top_) {
+                        throw std::bad_alloc();
+                    }
+                    arena_end_ = arena_top_ + ARENA_BLOCK_SIZE;
+                }
+                p = arena_top_;
+                arena_top_ += size;
+            }
+
+            symbol* sym = reinterpret_cast<symbol*>(p);
+            sym->hash = h;
+            sym->length = static_cast<uint32_t>(length);
+            memcpy(sym->name, name, length);
+            sym->name[length] = '\0';
+            return sym;
+        }
+
+        slot*  slots_;
+        size_t mask_;
+        size_t count_;
+        char*  arena_top_;
+        char*  arena_end_;
+    };
+
+    static symbol_table& the_symbol_table()
+    {
+        static symbol_table TABLE;
+        return TABLE;
+    }
+
+    /* readers on several threads may intern at once */
+    static std::mutex SYMBOL_LOCK;
+
+    const symbol* intern(const char* name, size_t length)
+    {
+        std::lock_guard<std::mutex> lock(SYMBOL_LOCK);
+        return the_symbol_table().intern(name, length);
+    }
+
+    size_t symbol_count(void)
+    {
+        std::lock_guard<std::mutex> lock(SYMBOL_LOCK);
+        return the_symbol_table().count();
+    }
+
+}//namespace uscheme
@@ -0,0 +1,70 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file symbol.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_TYPE_SYMBOL_HPP
+#define USCHEME_TYPE_SYMBOL_HPP
+
+// LANG includes
+#include <cstddef>
+#include <cstdint>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+
+namespace uscheme {
+
+    /**
+     * Interned symbol name. Records live in the symbol table arena for the
+     * life of the process, so there is exactly one per distinct name and
+     * symbols compare by address.
+     */
+    struct symbol
+    {
+        uint32_t hash;
+        uint32_t length;
+        char     name[8]; /* NUL terminated; actually length + 1 bytes */
+    };
+
+    USCHEME_API
+    /**
+     * Get the unique symbol for the length bytes at name, adding it to the
+     * symbol table on first use. Safe to call from any thread.
+     */
+    const symbol* intern(const char* name, size_t length);
+
+    USCHEME_API
+    /**
+     * Get the number of distinct symbols interned so far.
+     */
+    size_t symbol_count(void);
+
+}//namespace uscheme
+
+#endif//USCHEME_TYPE_SYMBOL_HPP
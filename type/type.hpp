@@ -39,7 +39,12 @@ enum object_type
     CHARACTER,
     STRING,
     FIXNUM,
-    EMPTY_LIST
+    EMPTY_LIST,
+    SYMBOL,
+    PAIR,
+    VECTOR,
+    BIGNUM,
+    FLONUM
 };
 
 }//namespace uscheme
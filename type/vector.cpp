@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file vector.cpp
+ * \date 2015
+ */
+
+// LANG includes
+#include <algorithm>
+#include <cstring>
+
+// PKG includes
+#include <uscheme/type/vector.hpp>
+#include <uscheme/gc/heap.hpp>
+
+#define ERROR_IF(cond, id)        \
+ if ((cond)) {                    \
+    throw uscheme::exception(id); \
+ }
+
+namespace uscheme {
+
+    /**
+     * The bulk write barrier: one check of the whole stored range instead
+     * of one barrier per element.
+     */
+    static void remember_stores(const object_ptr& v, const object_ptr* begin,
+                                const object_ptr* end)
+    {
+        if (gc_is_young(v.get())) {
+            return;
+        }
+        for (; begin != end; ++begin) {
+            if (begin->is_heap() && gc_is_young(begin->get())) {
+                gc_remember(v.get());
+                return;
+            }
+        }
+    }
+
+    object_ptr make_vector(size_t k, const object_ptr& fill)
+    {
+        return object::create_vector(k, fill);
+    }
+
+    object_ptr vector_ref(const object_ptr& v, size_t k)
+    {
+        ERROR_IF(!v.is_vector(), ERR_NOT_VEC);
+        ERROR_IF((k >= v.vector_length()), ERR_VEC_RANGE);
+        return v.vector_ref(k);
+    }
+
+    void vector_set(const object_ptr& v, size_t k, const object_ptr& obj)
+    {
+        ERROR_IF(!v.is_vector(), ERR_NOT_VEC);
+        ERROR_IF((k >= v.vector_length()), ERR_VEC_RANGE);
+        v.vector_set(k, obj);
+    }
+
+    void vector_fill(const object_ptr& v, const object_ptr& fill,
+                     size_t start, size_t end)
+    {
+        ERROR_IF(!v.is_vector(), ERR_NOT_VEC);
+        ERROR_IF((start > end) || (end > v.vector_length()), ERR_VEC_RANGE);
+        object_ptr* data = v.vector_data();
+        std::fill(data + start, data + end, fill);
+        if (start != end) {
+            remember_stores(v, &fill, &fill + 1);
+        }
+    }
+
+    void vector_copy(const object_ptr& to, size_t at,
+                     const object_ptr& from, size_t start, size_t end)
+    {
+        ERROR_IF(!to.is_vector() || !from.is_vector(), ERR_NOT_VEC);
+        ERROR_IF((start > end) || (end > from.vector_length()), ERR_VEC_RANGE);
+        ERROR_IF((at > to.vector_length()) ||
+                 (end - start > to.vector_length() - at), ERR_VEC_RANGE);
+        object_ptr* dst = to.vector_data() + at;
+        memmove(static_cast<void*>(dst), from.vector_data() + start,
+                (end - start) * sizeof(object_ptr));
+        remember_stores(to, dst, dst + (end - start));
+    }
+
+}//namespace uscheme
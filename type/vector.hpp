@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2015, Aaditya Kalsi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * \file vector.hpp
+ * \date 2015
+ */
+
+#ifndef USCHEME_TYPE_VECTOR_HPP
+#define USCHEME_TYPE_VECTOR_HPP
+
+// LANG includes
+#include <cstddef>
+
+// PKG includes
+#include <uscheme/defs.hpp>
+#include <uscheme/except.hpp>
+#include <uscheme/type/object.hpp>
+
+namespace uscheme {
+
+    USCHEME_API
+    /**
+     * make-vector: a vector of k elements set to fill.
+     */
+    object_ptr make_vector(size_t k, const object_ptr& fill);
+
+    USCHEME_API
+    /**
+     * vector-ref. Throws ERR_NOT_VEC or ERR_VEC_RANGE.
+     */
+    object_ptr vector_ref(const object_ptr& v, size_t k);
+
+    USCHEME_API
+    /**
+     * vector-set!. Throws ERR_NOT_VEC or ERR_VEC_RANGE.
+     */
+    void vector_set(const object_ptr& v, size_t k, const object_ptr& obj);
+
+    USCHEME_API
+    /**
+     * vector-fill!: set elements [start, end) of v to fill.
+     */
+    void vector_fill(const object_ptr& v, const object_ptr& fill,
+                     size_t start, size_t end);
+
+    USCHEME_API
+    /**
+     * vector-copy!: copy elements [start, end) of from into to, starting at
+     * index at. The ranges may overlap.
+     */
+    void vector_copy(const object_ptr& to, size_t at,
+                     const object_ptr& from, size_t start, size_t end);
+
+}//namespace uscheme
+
+#endif//USCHEME_TYPE_VECTOR_HPP